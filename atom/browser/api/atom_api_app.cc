@@ -15,6 +15,7 @@
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/ipc_stats.h"
 #include "atom/browser/login_handler.h"
 #include "atom/browser/net/atom_network_delegate.h"
 #include "atom/browser/relauncher.h"
@@ -28,6 +29,7 @@
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
 #include "atom/common/pepper_flash_util.h"
+#include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/environment.h"
 #include "base/files/file_path.h"
@@ -39,6 +41,8 @@
 #include "brave/common/workers/v8_worker_thread.h"
 #include "brave/common/workers/worker_bindings.h"
 #include "brightray/browser/brightray_paths.h"
+#include "brightray/browser/browser_client.h"
+#include "brightray/browser/net_log.h"
 #include "chrome/browser/browser_process_impl.h"
 #include "chrome/common/chrome_paths.h"
 #include "components/component_updater/component_updater_paths.h"
@@ -427,6 +431,33 @@ int GetPathConstant(const std::string& name) {
     return -1;
 }
 
+brightray::NetLog* GetNetLog() {
+  return static_cast<brightray::NetLog*>(
+      brightray::BrowserClient::Get()->GetNetLog());
+}
+
+// Reads the `captureMode` of the options passed to the net log methods.
+bool GetNetLogCaptureMode(const mate::Dictionary& options,
+                          net::NetLogCaptureMode* capture_mode) {
+  std::string mode = "default";
+  options.Get("captureMode", &mode);
+  if (mode == "default")
+    *capture_mode = net::NetLogCaptureMode::Default();
+  else if (mode == "includeSensitive")
+    *capture_mode = net::NetLogCaptureMode::IncludeCookiesAndCredentials();
+  else if (mode == "everything")
+    *capture_mode = net::NetLogCaptureMode::IncludeSocketBytes();
+  else
+    return false;
+  return true;
+}
+
+void OnNetLogFileDone(const base::Callback<void(bool)>& callback,
+                      bool success) {
+  if (!callback.is_null())
+    callback.Run(success);
+}
+
 bool NotificationCallbackWrapper(
     const ProcessSingleton::NotificationCallback& callback,
     const base::CommandLine& cmd,
@@ -794,11 +825,90 @@ void App::SendMemoryPressureAlert() {
       base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
 }
 
+bool App::StartNetLogging(const base::FilePath& path, mate::Arguments* args) {
+  // A function is the callback, not the options.
+  mate::Dictionary options = mate::Dictionary::CreateEmpty(isolate());
+  v8::Local<v8::Value> next = args->PeekNext();
+  if (!next.IsEmpty() && next->IsObject() && !next->IsFunction())
+    args->GetNext(&options);
+
+  base::Callback<void(bool)> callback;
+  args->GetNext(&callback);
+
+  net::NetLogCaptureMode capture_mode;
+  if (!GetNetLogCaptureMode(options, &capture_mode)) {
+    args->ThrowError("Invalid `captureMode`");
+    return false;
+  }
+  return GetNetLog()->StartLoggingToFile(
+      path, capture_mode, base::Bind(&OnNetLogFileDone, callback));
+}
+
+void App::StopNetLogging(mate::Arguments* args) {
+  base::Closure callback = base::Bind(&base::DoNothing);
+  args->GetNext(&callback);
+  GetNetLog()->StopLoggingToFile(callback);
+}
+
+bool App::IsNetLogging() {
+  return GetNetLog()->IsLoggingToFile();
+}
+
+void App::EnableNetLogRingBuffer(mate::Arguments* args) {
+  mate::Dictionary options = mate::Dictionary::CreateEmpty(isolate());
+  args->GetNext(&options);
+
+  net::NetLogCaptureMode capture_mode;
+  if (!GetNetLogCaptureMode(options, &capture_mode)) {
+    args->ThrowError("Invalid `captureMode`");
+    return;
+  }
+
+  uint32_t max_bytes = 10 * 1024 * 1024;
+  options.Get("maxBytes", &max_bytes);
+  if (max_bytes == 0) {
+    args->ThrowError("`maxBytes` must be greater than 0");
+    return;
+  }
+  GetNetLog()->EnableRingBuffer(max_bytes, capture_mode);
+}
+
+void App::DisableNetLogRingBuffer() {
+  GetNetLog()->DisableRingBuffer();
+}
+
+void App::DumpNetLogRingBuffer(const base::FilePath& path,
+                               mate::Arguments* args) {
+  base::Callback<void(bool)> callback;
+  args->GetNext(&callback);
+  GetNetLog()->DumpRingBuffer(path, base::Bind(&OnNetLogFileDone, callback));
+}
+
+void App::StartIPCStats() {
+  IPCStats::GetInstance()->Start();
+}
+
+void App::StopIPCStats() {
+  IPCStats::GetInstance()->Stop();
+}
+
+v8::Local<v8::Value> App::GetIPCStats() {
+  return mate::ConvertToV8(isolate(), *IPCStats::GetInstance()->GetStats());
+}
+
+void App::ResetIPCStats() {
+  IPCStats::GetInstance()->Reset();
+}
+
 void App::PostMessage(int worker_id,
                       v8::Local<v8::Value> message,
                       mate::Arguments* args) {
-  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message))
-    args->ThrowError("Eror serializing message");
+  v8::Local<v8::Value> transfer_list;
+  args->GetNext(&transfer_list);
+  std::string error;
+  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message,
+                                        transfer_list, &error))
+    args->ThrowError(error);
 }
 
 void App::StopWorker(mate::Arguments* args) {
@@ -955,6 +1065,16 @@ void App::BuildPrototype(
       .SetMethod("isAccessibilitySupportEnabled",
                  &App::IsAccessibilitySupportEnabled)
       .SetMethod("sendMemoryPressureAlert", &App::SendMemoryPressureAlert)
+      .SetMethod("startNetLogging", &App::StartNetLogging)
+      .SetMethod("stopNetLogging", &App::StopNetLogging)
+      .SetMethod("isNetLogging", &App::IsNetLogging)
+      .SetMethod("enableNetLogRingBuffer", &App::EnableNetLogRingBuffer)
+      .SetMethod("disableNetLogRingBuffer", &App::DisableNetLogRingBuffer)
+      .SetMethod("dumpNetLogRingBuffer", &App::DumpNetLogRingBuffer)
+      .SetMethod("startIPCStats", &App::StartIPCStats)
+      .SetMethod("stopIPCStats", &App::StopIPCStats)
+      .SetMethod("getIPCStats", &App::GetIPCStats)
+      .SetMethod("resetIPCStats", &App::ResetIPCStats)
       .SetMethod("_postMessage", &App::PostMessage)
       .SetMethod("_startWorker", &App::StartWorker)
       .SetMethod("stopWorker", &App::StopWorker)
@@ -125,6 +125,16 @@ class App : public AtomBrowserClient::Delegate,
   void DisableHardwareAcceleration(mate::Arguments* args);
   bool IsAccessibilitySupportEnabled();
   void SendMemoryPressureAlert();
+  bool StartNetLogging(const base::FilePath& path, mate::Arguments* args);
+  void StopNetLogging(mate::Arguments* args);
+  bool IsNetLogging();
+  void EnableNetLogRingBuffer(mate::Arguments* args);
+  void DisableNetLogRingBuffer();
+  void DumpNetLogRingBuffer(const base::FilePath& path, mate::Arguments* args);
+  void StartIPCStats();
+  void StopIPCStats();
+  v8::Local<v8::Value> GetIPCStats();
+  void ResetIPCStats();
   void PostMessage(int worker_id,
                   v8::Local<v8::Value> message,
                   mate::Arguments* args);
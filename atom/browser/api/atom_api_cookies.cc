@@ -2,7 +2,14 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_cookies.h"
 
@@ -10,6 +17,8 @@
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_piece.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -17,6 +26,7 @@
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/cookies/cookie_monster.h"
+#include "net/cookies/cookie_options.h"
 #include "net/cookies/cookie_store.h"
 #include "net/cookies/cookie_util.h"
 #include "net/url_request/url_request_context.h"
@@ -32,6 +42,9 @@ struct Converter<atom::api::Cookies::Error> {
                                    atom::api::Cookies::Error val) {
     if (val == atom::api::Cookies::SUCCESS)
       return v8::Null(isolate);
+    else if (val == atom::api::Cookies::REMOVE_FAILED)
+      return v8::Exception::Error(
+          StringToV8(isolate, "Removing cookies failed"));
     else
       return v8::Exception::Error(StringToV8(isolate, "Setting cookie failed"));
   }
@@ -64,45 +77,77 @@ namespace api {
 
 namespace {
 
-// Returns whether |domain| matches |filter|.
-bool MatchesDomain(std::string filter, const std::string& domain) {
-  // Add a leading '.' character to the filter domain if it doesn't exist.
-  if (net::cookie_util::DomainIsHostOnly(filter))
-    filter.insert(0, ".");
-
-  std::string sub_domain(domain);
-  // Strip any leading '.' character from the input cookie domain.
-  if (!net::cookie_util::DomainIsHostOnly(sub_domain))
-    sub_domain = sub_domain.substr(1);
-
-  // Now check whether the domain argument is a subdomain of the filter domain.
-  for (sub_domain.insert(0, "."); sub_domain.length() >= filter.length();) {
-    if (sub_domain == filter)
-      return true;
-    const size_t next_dot = sub_domain.find('.', 1);  // Skip over leading dot.
-    sub_domain.erase(0, next_dot);
-  }
-  return false;
-}
+// Returns whether |domain| is |filter| or one of its subdomains. Leading
+// dots are ignored on both sides.
+bool MatchesDomain(base::StringPiece filter, base::StringPiece domain) {
+  if (filter.starts_with("."))
+    filter.remove_prefix(1);
+  if (domain.starts_with("."))
+    domain.remove_prefix(1);
 
-// Returns whether |cookie| matches |filter|.
-bool MatchesCookie(const base::DictionaryValue* filter,
-                   const net::CanonicalCookie& cookie) {
-  std::string str;
-  bool b;
-  if (filter->GetString("name", &str) && str != cookie.Name())
-    return false;
-  if (filter->GetString("path", &str) && str != cookie.Path())
-    return false;
-  if (filter->GetString("domain", &str) && !MatchesDomain(str, cookie.Domain()))
+  if (filter.empty() || !domain.ends_with(filter))
     return false;
-  if (filter->GetBoolean("secure", &b) && b != cookie.IsSecure())
-    return false;
-  if (filter->GetBoolean("session", &b) && b != !cookie.IsPersistent())
-    return false;
-  return true;
+  return domain.size() == filter.size() ||
+         domain[domain.size() - filter.size() - 1] == '.';
 }
 
+// A cookies.get() filter, parsed once rather than for every cookie.
+class CookieFilter {
+ public:
+  explicit CookieFilter(const base::DictionaryValue& filter)
+      : secure_(false),
+        session_(false) {
+    std::string url;
+    if (filter.GetString("url", &url) && !url.empty())
+      url_ = GURL(url);
+    has_name_ = filter.GetString("name", &name_);
+    has_path_ = filter.GetString("path", &path_);
+    has_domain_ = filter.GetString("domain", &domain_);
+    has_secure_ = filter.GetBoolean("secure", &secure_);
+    has_session_ = filter.GetBoolean("session", &session_);
+
+    // Same options as CookieMonster::GetAllCookiesForURLAsync.
+    url_options_.set_include_httponly();
+    url_options_.set_same_site_cookie_mode(
+        net::CookieOptions::SameSiteCookieMode::INCLUDE_STRICT_AND_LAX);
+  }
+
+  // Empty to match the cookies of all urls.
+  const GURL& url() const { return url_; }
+
+  bool Matches(const net::CanonicalCookie& cookie) const {
+    if (!url_.is_empty() && !cookie.IncludeForRequestURL(url_, url_options_))
+      return false;
+    if (has_name_ && name_ != cookie.Name())
+      return false;
+    if (has_path_ && path_ != cookie.Path())
+      return false;
+    if (has_domain_ && !MatchesDomain(domain_, cookie.Domain()))
+      return false;
+    if (has_secure_ && secure_ != cookie.IsSecure())
+      return false;
+    if (has_session_ && session_ != !cookie.IsPersistent())
+      return false;
+    return true;
+  }
+
+ private:
+  GURL url_;
+  net::CookieOptions url_options_;
+  bool has_name_;
+  std::string name_;
+  bool has_path_;
+  std::string path_;
+  bool has_domain_;
+  std::string domain_;
+  bool secure_;
+  bool has_secure_;
+  bool session_;
+  bool has_session_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieFilter);
+};
+
 // Helper to returns the CookieStore.
 inline net::CookieStore* GetCookieStore(
     scoped_refptr<net::URLRequestContextGetter> getter) {
@@ -115,33 +160,37 @@ void RunCallbackInUI(const base::Closure& callback) {
 }
 
 // Remove cookies from |list| not matching |filter|, and pass it to |callback|.
-void FilterCookies(std::unique_ptr<base::DictionaryValue> filter,
+void FilterCookies(std::unique_ptr<CookieFilter> filter,
                    const Cookies::GetCallback& callback,
                    const net::CookieList& list) {
   net::CookieList result;
   for (const auto& cookie : list) {
-    if (MatchesCookie(filter.get(), cookie))
+    if (filter->Matches(cookie))
       result.push_back(cookie);
   }
   RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result));
 }
 
+// Passes the cookies that might match |filter| to |callback|. Queries by url
+// only load the cookies of that url's domain.
+void GetCookiesForFilter(
+    scoped_refptr<net::URLRequestContextGetter> getter,
+    const CookieFilter& filter,
+    const net::CookieStore::GetCookieListCallback& callback) {
+  if (filter.url().is_empty())
+    GetCookieStore(getter)->GetAllCookiesAsync(callback);
+  else
+    GetCookieStore(getter)->GetAllCookiesForURLAsync(filter.url(), callback);
+}
+
 // Receives cookies matching |filter| in IO thread.
 void GetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                    std::unique_ptr<base::DictionaryValue> filter,
+                    std::unique_ptr<CookieFilter> filter,
                     const Cookies::GetCallback& callback) {
-  std::string url;
-  filter->GetString("url", &url);
-
-  auto filtered_callback =
-      base::Bind(FilterCookies, base::Passed(&filter), callback);
-
-  // Empty url will match all url cookies.
-  if (url.empty())
-    GetCookieStore(getter)->GetAllCookiesAsync(filtered_callback);
-  else
-    GetCookieStore(getter)->GetAllCookiesForURLAsync(GURL(url),
-        filtered_callback);
+  const CookieFilter& filter_ref = *filter;
+  GetCookiesForFilter(
+      getter, filter_ref,
+      base::Bind(FilterCookies, base::Passed(&filter), callback));
 }
 
 // Removes cookie with |url| and |name| in IO thread.
@@ -158,61 +207,434 @@ void OnSetCookie(const Cookies::SetCallback& callback, bool success) {
       base::Bind(callback, success ? Cookies::SUCCESS : Cookies::FAILED));
 }
 
-// Sets cookie with |details| in IO thread.
-void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                   std::unique_ptr<base::DictionaryValue> details,
-                   const Cookies::SetCallback& callback) {
+// Sets the cookie described by |details|, as passed to cookies.set().
+void SetCookieWithDetails(
+    net::CookieStore* cookie_store,
+    const base::DictionaryValue& details,
+    const net::CookieStore::SetCookiesCallback& callback) {
   std::string url, name, value, domain, path;
   bool secure = false;
   bool http_only = false;
   double creation_date;
   double expiration_date;
   double last_access_date;
-  details->GetString("url", &url);
-  details->GetString("name", &name);
-  details->GetString("value", &value);
-  details->GetString("domain", &domain);
-  details->GetString("path", &path);
-  details->GetBoolean("secure", &secure);
-  details->GetBoolean("httpOnly", &http_only);
+  details.GetString("url", &url);
+  details.GetString("name", &name);
+  details.GetString("value", &value);
+  details.GetString("domain", &domain);
+  details.GetString("path", &path);
+  details.GetBoolean("secure", &secure);
+  details.GetBoolean("httpOnly", &http_only);
 
   base::Time creation_time;
-  if (details->GetDouble("creationDate", &creation_date)) {
+  if (details.GetDouble("creationDate", &creation_date)) {
     creation_time = (creation_date == 0) ?
         base::Time::UnixEpoch() :
         base::Time::FromDoubleT(creation_date);
   }
 
   base::Time expiration_time;
-  if (details->GetDouble("expirationDate", &expiration_date)) {
+  if (details.GetDouble("expirationDate", &expiration_date)) {
     expiration_time = (expiration_date == 0) ?
         base::Time::UnixEpoch() :
         base::Time::FromDoubleT(expiration_date);
   }
 
   base::Time last_access_time;
-  if (details->GetDouble("lastAccessDate", &last_access_date)) {
+  if (details.GetDouble("lastAccessDate", &last_access_date)) {
     last_access_time = (last_access_date == 0) ?
         base::Time::UnixEpoch() :
         base::Time::FromDoubleT(last_access_date);
   }
 
-  GetCookieStore(getter)->SetCookieWithDetailsAsync(
+  cookie_store->SetCookieWithDetailsAsync(
       GURL(url), name, value, domain, path, creation_time,
       expiration_time, last_access_time, secure, http_only,
       net::CookieSameSite::DEFAULT_MODE,
-      net::COOKIE_PRIORITY_DEFAULT, base::Bind(OnSetCookie, callback));
+      net::COOKIE_PRIORITY_DEFAULT, callback);
+}
+
+// Sets cookie with |details| in IO thread.
+void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                   std::unique_ptr<base::DictionaryValue> details,
+                   const Cookies::SetCallback& callback) {
+  SetCookieWithDetails(GetCookieStore(getter), *details,
+                       base::Bind(OnSetCookie, callback));
 }
 
+// Collects the per-cookie results of a batch operation. The results are
+// reported once every cookie store callback holding a reference has run.
+class CookieBatch : public base::RefCounted<CookieBatch> {
+ public:
+  using DoneCallback = base::Callback<void(const std::vector<int>&)>;
+
+  CookieBatch(size_t size, const DoneCallback& done)
+      : results_(size, 0),
+        done_(done) {
+  }
+
+  void AddResult(size_t index, int result) { results_[index] += result; }
+
+ private:
+  friend class base::RefCounted<CookieBatch>;
+
+  ~CookieBatch() { done_.Run(results_); }
+
+  std::vector<int> results_;
+  DoneCallback done_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieBatch);
+};
+
+void OnBatchCookieSet(scoped_refptr<CookieBatch> batch,
+                      size_t index,
+                      bool success) {
+  batch->AddResult(index, success ? 1 : 0);
+}
+
+void OnBatchCookieDeleted(scoped_refptr<CookieBatch> batch,
+                          size_t index,
+                          int num_deleted) {
+  batch->AddResult(index, num_deleted);
+}
+
+void OnSetManyDone(const Cookies::SetManyCallback& callback,
+                   const std::vector<int>& results) {
+  Cookies::Error error = Cookies::SUCCESS;
+  std::vector<bool> succeeded(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    succeeded[i] = results[i] > 0;
+    if (!succeeded[i])
+      error = Cookies::FAILED;
+  }
+  RunCallbackInUI(base::Bind(callback, error, succeeded));
+}
+
+void OnRemoveManyDone(const Cookies::RemoveManyCallback& callback,
+                      Cookies::Error error,
+                      const std::vector<int>& results) {
+  RunCallbackInUI(base::Bind(callback, error, results));
+}
+
+// Sets every cookie of |cookies| in IO thread.
+void SetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    std::unique_ptr<base::ListValue> cookies,
+                    const Cookies::SetManyCallback& callback) {
+  net::CookieStore* cookie_store = GetCookieStore(getter);
+  scoped_refptr<CookieBatch> batch(new CookieBatch(
+      cookies->GetSize(), base::Bind(OnSetManyDone, callback)));
+  for (size_t i = 0; i < cookies->GetSize(); ++i) {
+    const base::DictionaryValue* details = nullptr;
+    if (cookies->GetDictionary(i, &details)) {
+      SetCookieWithDetails(cookie_store, *details,
+                           base::Bind(OnBatchCookieSet, batch, i));
+    }
+  }
+}
+
+// Deletes the cookies that cookies.remove() would delete for each
+// {url, name} of |cookies|, out of the cookies in |list|. Entries without a
+// url or a name fail the whole batch, the others are still removed.
+void RemoveMatchingCookies(scoped_refptr<net::URLRequestContextGetter> getter,
+                           std::unique_ptr<base::ListValue> cookies,
+                           const Cookies::RemoveManyCallback& callback,
+                           const net::CookieList& list) {
+  std::map<std::string, std::vector<size_t>> cookies_by_name;
+  for (size_t i = 0; i < list.size(); ++i)
+    cookies_by_name[list[i].Name()].push_back(i);
+
+  // Same options as CookieMonster::DeleteCookie.
+  net::CookieOptions options;
+  options.set_include_httponly();
+  options.set_same_site_cookie_mode(
+      net::CookieOptions::SameSiteCookieMode::INCLUDE_STRICT_AND_LAX);
+
+  std::vector<std::pair<GURL, std::string>> entries(cookies->GetSize());
+  Cookies::Error error = Cookies::SUCCESS;
+  for (size_t i = 0; i < cookies->GetSize(); ++i) {
+    const base::DictionaryValue* details = nullptr;
+    std::string url;
+    if (!cookies->GetDictionary(i, &details) ||
+        !details->GetString("url", &url) ||
+        !details->GetString("name", &entries[i].second)) {
+      error = Cookies::REMOVE_FAILED;
+      continue;
+    }
+    entries[i].first = GURL(url);
+  }
+
+  net::CookieStore* cookie_store = GetCookieStore(getter);
+  scoped_refptr<CookieBatch> batch(new CookieBatch(
+      entries.size(), base::Bind(OnRemoveManyDone, callback, error)));
+  std::vector<bool> deleted(list.size(), false);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto it = cookies_by_name.find(entries[i].second);
+    if (!entries[i].first.is_valid() || it == cookies_by_name.end())
+      continue;
+
+    for (size_t index : it->second) {
+      if (deleted[index] ||
+          !list[index].IncludeForRequestURL(entries[i].first, options))
+        continue;
+      deleted[index] = true;
+      cookie_store->DeleteCanonicalCookieAsync(
+          list[index], base::Bind(OnBatchCookieDeleted, batch, i));
+    }
+  }
+}
+
+// Removes every {url, name} of |cookies| in IO thread.
+void RemoveCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       std::unique_ptr<base::ListValue> cookies,
+                       const Cookies::RemoveManyCallback& callback) {
+  GetCookieStore(getter)->GetAllCookiesAsync(
+      base::Bind(RemoveMatchingCookies, getter, base::Passed(&cookies),
+                 callback));
+}
+
+// Describes |cookie| in the format accepted by cookies.set().
+std::unique_ptr<base::DictionaryValue> CookieToDetails(
+    const net::CanonicalCookie& cookie) {
+  bool host_only = net::cookie_util::DomainIsHostOnly(cookie.Domain());
+  std::string host = host_only ? cookie.Domain() : cookie.Domain().substr(1);
+
+  std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
+  details->SetString("url", std::string(cookie.IsSecure() ? "https" : "http") +
+                            "://" + host + cookie.Path());
+  details->SetString("name", cookie.Name());
+  details->SetString("value", cookie.Value());
+  // Setting a domain would turn a host-only cookie into a domain cookie.
+  if (!host_only)
+    details->SetString("domain", cookie.Domain());
+  details->SetString("path", cookie.Path());
+  details->SetBoolean("secure", cookie.IsSecure());
+  details->SetBoolean("httpOnly", cookie.IsHttpOnly());
+  details->SetDouble("creationDate", cookie.CreationDate().ToDoubleT());
+  details->SetDouble("lastAccessDate", cookie.LastAccessDate().ToDoubleT());
+  if (cookie.IsPersistent())
+    details->SetDouble("expirationDate", cookie.ExpiryDate().ToDoubleT());
+  return details;
+}
+
+void RunExportCallback(const Cookies::ExportCallback& callback,
+                       std::unique_ptr<base::ListValue> cookies) {
+  callback.Run(Cookies::SUCCESS, *cookies);
+}
+
+// Converts the cookies of |list| matching |filter| and passes them to
+// |callback|.
+void ExportCookies(std::unique_ptr<CookieFilter> filter,
+                   const Cookies::ExportCallback& callback,
+                   const net::CookieList& list) {
+  std::unique_ptr<base::ListValue> cookies(new base::ListValue);
+  for (const auto& cookie : list) {
+    if (filter->Matches(cookie))
+      cookies->Append(CookieToDetails(cookie));
+  }
+  RunCallbackInUI(
+      base::Bind(RunExportCallback, callback, base::Passed(&cookies)));
+}
+
+// Exports cookies matching |filter| in IO thread.
+void ExportCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       std::unique_ptr<CookieFilter> filter,
+                       const Cookies::ExportCallback& callback) {
+  const CookieFilter& filter_ref = *filter;
+  GetCookiesForFilter(
+      getter, filter_ref,
+      base::Bind(ExportCookies, base::Passed(&filter), callback));
+}
+
+// A cookies.query() request.
+struct CookieQuery {
+  explicit CookieQuery(const base::DictionaryValue& options)
+      : filter(options),
+        offset(0),
+        limit(std::numeric_limits<size_t>::max()) {
+    int value;
+    if (options.GetInteger("offset", &value) && value > 0)
+      offset = value;
+    if (options.GetInteger("limit", &value) && value > 0)
+      limit = value;
+
+    const base::ListValue* list = nullptr;
+    if (options.GetList("fields", &list)) {
+      for (const auto& field : *list) {
+        std::string name;
+        if (field->GetAsString(&name))
+          fields.insert(name);
+      }
+    }
+  }
+
+  CookieFilter filter;
+  size_t offset;
+  size_t limit;
+  // The cookie properties to return, all of them when empty.
+  std::set<std::string> fields;
+};
+
+// Describes |cookie| like the cookies returned by cookies.get(), limited to
+// |fields| unless it is empty.
+std::unique_ptr<base::DictionaryValue> CookieToValue(
+    const net::CanonicalCookie& cookie,
+    const std::set<std::string>& fields) {
+  auto wants = [&fields](const char* field) {
+    return fields.empty() || fields.count(field) > 0;
+  };
+
+  std::unique_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  if (wants("name"))
+    value->SetString("name", cookie.Name());
+  if (wants("value"))
+    value->SetString("value", cookie.Value());
+  if (wants("domain"))
+    value->SetString("domain", cookie.Domain());
+  if (wants("hostOnly")) {
+    value->SetBoolean("hostOnly",
+                      net::cookie_util::DomainIsHostOnly(cookie.Domain()));
+  }
+  if (wants("path"))
+    value->SetString("path", cookie.Path());
+  if (wants("secure"))
+    value->SetBoolean("secure", cookie.IsSecure());
+  if (wants("httpOnly"))
+    value->SetBoolean("httpOnly", cookie.IsHttpOnly());
+  if (wants("session"))
+    value->SetBoolean("session", !cookie.IsPersistent());
+  if (wants("expirationDate") && cookie.IsPersistent())
+    value->SetDouble("expirationDate", cookie.ExpiryDate().ToDoubleT());
+  return value;
+}
+
+void RunQueryCallback(const Cookies::QueryCallback& callback,
+                      std::unique_ptr<base::DictionaryValue> page) {
+  callback.Run(Cookies::SUCCESS, *page);
+}
+
+// Converts the page of |list| that |query| asks for and passes it to
+// |callback|, along with the offset of the next page if there is one.
+void QueryCookies(std::unique_ptr<CookieQuery> query,
+                  const Cookies::QueryCallback& callback,
+                  const net::CookieList& list) {
+  std::unique_ptr<base::ListValue> cookies(new base::ListValue);
+  size_t matched = 0;
+  bool has_more = false;
+  for (const auto& cookie : list) {
+    if (!query->filter.Matches(cookie) || matched++ < query->offset)
+      continue;
+    if (cookies->GetSize() == query->limit) {
+      has_more = true;
+      break;
+    }
+    cookies->Append(CookieToValue(cookie, query->fields));
+  }
+
+  std::unique_ptr<base::DictionaryValue> page(new base::DictionaryValue);
+  if (has_more) {
+    page->SetInteger("nextOffset",
+                     static_cast<int>(query->offset + cookies->GetSize()));
+  }
+  page->Set("cookies", std::move(cookies));
+  RunCallbackInUI(
+      base::Bind(RunQueryCallback, callback, base::Passed(&page)));
+}
+
+// Runs |query| in IO thread.
+void QueryCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                      std::unique_ptr<CookieQuery> query,
+                      const Cookies::QueryCallback& callback) {
+  const CookieFilter& filter = query->filter;
+  GetCookiesForFilter(
+      getter, filter,
+      base::Bind(QueryCookies, base::Passed(&query), callback));
+}
+
+void OnCookiesClearedForImport(
+    scoped_refptr<net::URLRequestContextGetter> getter,
+    std::unique_ptr<base::ListValue> cookies,
+    const Cookies::SetManyCallback& callback,
+    int num_deleted) {
+  SetCookiesOnIO(getter, std::move(cookies), callback);
+}
+
+// Sets every cookie of |cookies| in IO thread, after deleting all the
+// existing cookies if |replace| is set.
+void ImportCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       std::unique_ptr<base::ListValue> cookies,
+                       bool replace,
+                       const Cookies::SetManyCallback& callback) {
+  if (!replace) {
+    SetCookiesOnIO(getter, std::move(cookies), callback);
+    return;
+  }
+
+  GetCookieStore(getter)->DeleteAllAsync(
+      base::Bind(OnCookiesClearedForImport, getter, base::Passed(&cookies),
+                 callback));
+}
+
+// How often batches of cookie changes are delivered by default.
+const int kDefaultChangeIntervalMs = 500;
+
+bool MatchesFilter(const CookieFilter* filter,
+                   const net::CanonicalCookie& cookie) {
+  return filter->Matches(cookie);
+}
+
+const char* ChangeCauseToString(bool removed,
+                                net::CookieStore::ChangeCause cause) {
+  if (!removed)
+    return "added";
+
+  switch (cause) {
+    case net::CookieStore::ChangeCause::OVERWRITE:
+      return "overwritten";
+    case net::CookieStore::ChangeCause::EXPIRED:
+    case net::CookieStore::ChangeCause::EXPIRED_OVERWRITE:
+      return "expired";
+    case net::CookieStore::ChangeCause::EVICTED:
+      return "evicted";
+    default:
+      return "removed";
+  }
+}
+
+// Converts a batch of |changes| and passes it to |callback| in UI thread.
+void OnCookiesChangedOnIO(
+    const base::Callback<void(std::unique_ptr<base::ListValue>)>& callback,
+    const std::vector<AtomCookieDelegate::Change>& changes) {
+  std::unique_ptr<base::ListValue> list(new base::ListValue);
+  for (const auto& change : changes) {
+    std::unique_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+    value->Set("cookie",
+               CookieToValue(change.cookie, std::set<std::string>()));
+    value->SetString("cause",
+                     ChangeCauseToString(change.removed, change.cause));
+    list->Append(std::move(value));
+  }
+  RunCallbackInUI(base::Bind(callback, base::Passed(&list)));
+}
+
+int g_next_change_subscription_id = 0;
+
 }  // namespace
 
 Cookies::Cookies(v8::Isolate* isolate,
                  AtomBrowserContext* browser_context)
-      : request_context_getter_(browser_context->url_request_context_getter()) {
+      : request_context_getter_(browser_context->url_request_context_getter()),
+        cookie_delegate_(browser_context->cookie_delegate()),
+        weak_factory_(this) {
   Init(isolate);
 }
 
 Cookies::~Cookies() {
+  for (const auto& it : change_callbacks_) {
+    content::BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&AtomCookieDelegate::RemoveSubscription, cookie_delegate_,
+                   it.first));
+  }
 }
 
 // TODO(klawler): 2017.06.29
@@ -228,11 +650,28 @@ void Cookies::GetAll(const base::DictionaryValue& filter,
 
 void Cookies::Get(const base::DictionaryValue& filter,
                   const GetCallback& callback) {
-  std::unique_ptr<base::DictionaryValue> copied(filter.CreateDeepCopy());
+  std::unique_ptr<CookieFilter> parsed(new CookieFilter(filter));
   auto getter = base::RetainedRef(request_context_getter_);
   content::BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
-      base::Bind(GetCookiesOnIO, getter, Passed(&copied), callback));
+      base::Bind(GetCookiesOnIO, getter, Passed(&parsed), callback));
+}
+
+void Cookies::Query(const base::DictionaryValue& options,
+                    const QueryCallback& callback,
+                    mate::Arguments* args) {
+  // An empty page would point at itself as the next one.
+  int limit;
+  if (options.GetInteger("limit", &limit) && limit < 1) {
+    args->ThrowError("`limit` must be greater than 0");
+    return;
+  }
+
+  std::unique_ptr<CookieQuery> query(new CookieQuery(options));
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(QueryCookiesOnIO, getter, Passed(&query), callback));
 }
 
 void Cookies::Remove(const GURL& url, const std::string& name,
@@ -252,6 +691,108 @@ void Cookies::Set(const base::DictionaryValue& details,
       base::Bind(SetCookieOnIO, getter, Passed(&copied), callback));
 }
 
+void Cookies::SetMany(const base::ListValue& cookies,
+                      const SetManyCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(cookies.CreateDeepCopy());
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(SetCookiesOnIO, getter, Passed(&copied), callback));
+}
+
+void Cookies::RemoveMany(const base::ListValue& cookies,
+                         const RemoveManyCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(cookies.CreateDeepCopy());
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(RemoveCookiesOnIO, getter, Passed(&copied), callback));
+}
+
+void Cookies::Export(mate::Arguments* args) {
+  base::DictionaryValue options;
+  if (!args->PeekNext().IsEmpty() && !args->PeekNext()->IsFunction())
+    args->GetNext(&options);
+  std::unique_ptr<CookieFilter> filter(new CookieFilter(options));
+
+  ExportCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("`callback` is a required field");
+    return;
+  }
+
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(ExportCookiesOnIO, getter, Passed(&filter), callback));
+}
+
+void Cookies::Import(mate::Arguments* args) {
+  std::unique_ptr<base::ListValue> cookies(new base::ListValue);
+  if (!args->GetNext(cookies.get())) {
+    args->ThrowError("`cookies` must be an array");
+    return;
+  }
+
+  bool replace = false;
+  mate::Dictionary options;
+  if (!args->PeekNext().IsEmpty() && !args->PeekNext()->IsFunction() &&
+      args->GetNext(&options))
+    options.Get("replace", &replace);
+
+  SetManyCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("`callback` is a required field");
+    return;
+  }
+
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(ImportCookiesOnIO, getter, Passed(&cookies), replace,
+                 callback));
+}
+
+int Cookies::Subscribe(const base::DictionaryValue& options,
+                       const ChangesCallback& callback) {
+  int interval_ms = kDefaultChangeIntervalMs;
+  options.GetInteger("interval", &interval_ms);
+
+  int id = ++g_next_change_subscription_id;
+  change_callbacks_[id] = callback;
+
+  auto filter = base::Bind(MatchesFilter,
+                           base::Owned(new CookieFilter(options)));
+  auto changes_callback =
+      base::Bind(OnCookiesChangedOnIO,
+                 base::Bind(&Cookies::OnCookiesChanged,
+                            weak_factory_.GetWeakPtr(), id));
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&AtomCookieDelegate::AddSubscription, cookie_delegate_, id,
+                 filter,
+                 base::TimeDelta::FromMilliseconds(std::max(interval_ms, 0)),
+                 changes_callback));
+  return id;
+}
+
+void Cookies::Unsubscribe(int id) {
+  if (!change_callbacks_.erase(id))
+    return;
+
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&AtomCookieDelegate::RemoveSubscription, cookie_delegate_,
+                 id));
+}
+
+void Cookies::OnCookiesChanged(int id,
+                               std::unique_ptr<base::ListValue> changes) {
+  auto it = change_callbacks_.find(id);
+  if (it != change_callbacks_.end())
+    it->second.Run(*changes);
+}
+
 // static
 mate::Handle<Cookies> Cookies::Create(
     v8::Isolate* isolate,
@@ -265,8 +806,15 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
   prototype->SetClassName(mate::StringToV8(isolate, "Cookies"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("get", &Cookies::Get)
+      .SetMethod("query", &Cookies::Query)
       .SetMethod("remove", &Cookies::Remove)
       .SetMethod("set", &Cookies::Set)
+      .SetMethod("setMany", &Cookies::SetMany)
+      .SetMethod("removeMany", &Cookies::RemoveMany)
+      .SetMethod("export", &Cookies::Export)
+      .SetMethod("import", &Cookies::Import)
+      .SetMethod("subscribe", &Cookies::Subscribe)
+      .SetMethod("unsubscribe", &Cookies::Unsubscribe)
       .SetMethod("getAll", &Cookies::GetAll);
 }
 
@@ -5,15 +5,25 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 #define ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
+#include "atom/browser/net/atom_cookie_delegate.h"
 #include "base/callback.h"
+#include "base/memory/weak_ptr.h"
 #include "native_mate/handle.h"
 #include "net/cookies/canonical_cookie.h"
 
 namespace base {
 class DictionaryValue;
+class ListValue;
+}
+
+namespace mate {
+class Arguments;
 }
 
 namespace net {
@@ -31,10 +41,19 @@ class Cookies : public mate::TrackableObject<Cookies> {
   enum Error {
     SUCCESS,
     FAILED,
+    REMOVE_FAILED,
   };
 
   using GetCallback = base::Callback<void(Error, const net::CookieList&)>;
   using SetCallback = base::Callback<void(Error)>;
+  using SetManyCallback =
+      base::Callback<void(Error, const std::vector<bool>&)>;
+  using RemoveManyCallback =
+      base::Callback<void(Error, const std::vector<int>&)>;
+  using ExportCallback = base::Callback<void(Error, const base::ListValue&)>;
+  using QueryCallback =
+      base::Callback<void(Error, const base::DictionaryValue&)>;
+  using ChangesCallback = base::Callback<void(const base::ListValue&)>;
 
   static mate::Handle<Cookies> Create(v8::Isolate* isolate,
                                       AtomBrowserContext* browser_context);
@@ -49,12 +68,36 @@ class Cookies : public mate::TrackableObject<Cookies> {
 
   void GetAll(const base::DictionaryValue& filter, const GetCallback& callback);
   void Get(const base::DictionaryValue& filter, const GetCallback& callback);
+  void Query(const base::DictionaryValue& options,
+             const QueryCallback& callback,
+             mate::Arguments* args);
   void Remove(const GURL& url, const std::string& name,
               const base::Closure& callback);
   void Set(const base::DictionaryValue& details, const SetCallback& callback);
 
+  // Batch versions of the above, each running as a single task on the cookie
+  // store.
+  void SetMany(const base::ListValue& cookies,
+               const SetManyCallback& callback);
+  void RemoveMany(const base::ListValue& cookies,
+                  const RemoveManyCallback& callback);
+  void Export(mate::Arguments* args);
+  void Import(mate::Arguments* args);
+
+  // Calls |callback| with batches of changes to the cookies matching the
+  // filter in |options|, returns the id to pass to Unsubscribe.
+  int Subscribe(const base::DictionaryValue& options,
+                const ChangesCallback& callback);
+  void Unsubscribe(int id);
+
  private:
+  void OnCookiesChanged(int id, std::unique_ptr<base::ListValue> changes);
+
   net::URLRequestContextGetter* request_context_getter_;
+  scoped_refptr<AtomCookieDelegate> cookie_delegate_;
+  std::map<int, ChangesCallback> change_callbacks_;
+
+  base::WeakPtrFactory<Cookies> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Cookies);
 };
@@ -88,6 +88,10 @@ void DownloadItem::OnDownloadUpdated(content::DownloadItem* item) {
 }
 
 void DownloadItem::OnDownloadDestroyed(content::DownloadItem* download_item) {
+  // The updates still held back are delivered while the item can be used.
+  if (!FlushCoalescedEvents())
+    return;
+
   download_item_ = nullptr;
   // Destroy the native class immediately when downloadItem is destroyed.
   delete this;
@@ -189,6 +193,7 @@ void DownloadItem::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isDone", &DownloadItem::IsDone)
       .SetMethod("setSavePath", &DownloadItem::SetSavePath)
       .SetMethod("getSavePath", &DownloadItem::GetSavePath)
+      .SetMethod("setEventCoalescing", &DownloadItem::SetEventCoalescing)
       .SetMethod("promptForSaveLocation", &DownloadItem::PromptForSaveLocation);
 }
 
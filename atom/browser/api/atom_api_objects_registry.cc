@@ -0,0 +1,169 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_objects_registry.h"
+
+#include "atom/common/node_includes.h"
+#include "native_mate/dictionary.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+base::LazyInstance<ObjectsRegistry>::Leaky g_objects_registry =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+ObjectsRegistry::Entry::Entry() : hash(0), count(0) {
+}
+
+ObjectsRegistry::Entry::~Entry() {
+}
+
+// static
+ObjectsRegistry* ObjectsRegistry::GetInstance() {
+  return g_objects_registry.Pointer();
+}
+
+ObjectsRegistry::ObjectsRegistry() : next_id_(0) {
+}
+
+ObjectsRegistry::~ObjectsRegistry() {
+}
+
+int32_t ObjectsRegistry::Add(v8::Isolate* isolate,
+                             int32_t owner_id,
+                             v8::Local<v8::Object> object) {
+  int hash = object->GetIdentityHash();
+  int32_t id = 0;
+  auto range = ids_by_hash_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (storage_.at(it->second).object == object) {
+      id = it->second;
+      break;
+    }
+  }
+
+  if (!id) {
+    id = ++next_id_;
+    Entry& entry = storage_[id];
+    entry.object.Reset(isolate, object);
+    entry.hash = hash;
+    ids_by_hash_.emplace(hash, id);
+  }
+
+  // An owner holds a single reference however many times it gets the object.
+  if (owners_[owner_id][id]++ == 0)
+    storage_[id].count++;
+  return id;
+}
+
+v8::MaybeLocal<v8::Object> ObjectsRegistry::Get(v8::Isolate* isolate,
+                                                int32_t id) const {
+  auto it = storage_.find(id);
+  if (it == storage_.end())
+    return v8::MaybeLocal<v8::Object>();
+  return v8::Local<v8::Object>::New(isolate, it->second.object);
+}
+
+void ObjectsRegistry::Remove(int32_t owner_id, int32_t id, int32_t count) {
+  // Don't let an owner remove itself.
+  if (owner_id == id)
+    return;
+
+  auto owner = owners_.find(owner_id);
+  if (owner == owners_.end())
+    return;
+  auto it = owner->second.find(id);
+  if (it == owner->second.end())
+    return;
+
+  // The object was sent again since the renderer released it.
+  it->second -= count;
+  if (it->second > 0)
+    return;
+
+  owner->second.erase(it);
+  Dereference(id);
+}
+
+void ObjectsRegistry::Clear(int32_t owner_id) {
+  auto owner = owners_.find(owner_id);
+  if (owner == owners_.end())
+    return;
+
+  for (const auto& it : owner->second)
+    Dereference(it.first);
+  owners_.erase(owner);
+}
+
+size_t ObjectsRegistry::GetCount(int32_t owner_id) const {
+  auto owner = owners_.find(owner_id);
+  return owner == owners_.end() ? 0 : owner->second.size();
+}
+
+void ObjectsRegistry::Dereference(int32_t id) {
+  auto it = storage_.find(id);
+  if (it == storage_.end() || --it->second.count > 0)
+    return;
+
+  auto range = ids_by_hash_.equal_range(it->second.hash);
+  for (auto hash_it = range.first; hash_it != range.second; ++hash_it) {
+    if (hash_it->second == id) {
+      ids_by_hash_.erase(hash_it);
+      break;
+    }
+  }
+  storage_.erase(it);
+}
+
+}  // namespace api
+
+}  // namespace atom
+
+namespace {
+
+using atom::api::ObjectsRegistry;
+
+int32_t Add(v8::Isolate* isolate,
+            int32_t owner_id,
+            v8::Local<v8::Object> object) {
+  return ObjectsRegistry::GetInstance()->Add(isolate, owner_id, object);
+}
+
+v8::Local<v8::Value> Get(v8::Isolate* isolate, int32_t id) {
+  v8::Local<v8::Object> object;
+  if (!ObjectsRegistry::GetInstance()->Get(isolate, id).ToLocal(&object))
+    return v8::Undefined(isolate);
+  return object;
+}
+
+void Remove(int32_t owner_id, int32_t id, int32_t count) {
+  ObjectsRegistry::GetInstance()->Remove(owner_id, id, count);
+}
+
+void Clear(int32_t owner_id) {
+  ObjectsRegistry::GetInstance()->Clear(owner_id);
+}
+
+uint32_t GetCount(int32_t owner_id) {
+  return ObjectsRegistry::GetInstance()->GetCount(owner_id);
+}
+
+void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context, void* priv) {
+  mate::Dictionary dict(context->GetIsolate(), exports);
+  dict.SetMethod("add", &Add);
+  dict.SetMethod("get", &Get);
+  dict.SetMethod("remove", &Remove);
+  dict.SetMethod("clear", &Clear);
+  dict.SetMethod("getCount", &GetCount);
+}
+
+}  // namespace
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(atom_browser_objects_registry, Initialize)
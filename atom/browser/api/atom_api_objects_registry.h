@@ -0,0 +1,81 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_OBJECTS_REGISTRY_H_
+#define ATOM_BROWSER_API_ATOM_API_OBJECTS_REGISTRY_H_
+
+#include <map>
+#include <unordered_map>
+
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+namespace api {
+
+// Keeps the objects that renderers reference through the remote module alive,
+// with one reference per WebContents that holds them. Owners are identified
+// by webContents.getId().
+//
+// An owner releases an object by the number of times it received it, so that
+// a release sent before the object was received again can't drop it.
+class ObjectsRegistry {
+ public:
+  static ObjectsRegistry* GetInstance();
+
+  // Returns the id of |object|, registering it first if needed, and counts
+  // it as sent to |owner_id|.
+  int32_t Add(v8::Isolate* isolate,
+              int32_t owner_id,
+              v8::Local<v8::Object> object);
+
+  // Returns an empty handle if there is no object with |id|.
+  v8::MaybeLocal<v8::Object> Get(v8::Isolate* isolate, int32_t id) const;
+
+  // Releases |count| of the times the object with |id| was sent to
+  // |owner_id|, and its reference once they all are.
+  void Remove(int32_t owner_id, int32_t id, int32_t count);
+
+  // Releases all the references of |owner_id|.
+  void Clear(int32_t owner_id);
+
+  // Returns the number of objects referenced by |owner_id|.
+  size_t GetCount(int32_t owner_id) const;
+
+ private:
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    v8::Global<v8::Object> object;
+    int hash;
+    int count;
+  };
+
+  ObjectsRegistry();
+  ~ObjectsRegistry();
+
+  void Dereference(int32_t id);
+
+  int32_t next_id_;
+  std::unordered_map<int32_t, Entry> storage_;
+
+  // Finds the id of an object without touching the object itself.
+  std::unordered_multimap<int, int32_t> ids_by_hash_;
+
+  // The number of times each object was sent to each owner, by id.
+  std::map<int32_t, std::map<int32_t, int32_t>> owners_;
+
+  friend struct base::LazyInstanceTraitsBase<ObjectsRegistry>;
+
+  DISALLOW_COPY_AND_ASSIGN(ObjectsRegistry);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_OBJECTS_REGISTRY_H_
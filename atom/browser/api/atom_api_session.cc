@@ -39,6 +39,9 @@
 #include "base/threading/thread_task_runner_handle.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/browser/brave_permission_manager.h"
+#include "brave/browser/net/no_state_prefetcher.h"
+#include "brave/browser/net/preconnect_predictor.h"
+#include "brightray/browser/url_request_context_getter.h"
 #include "chrome/browser/devtools/devtools_network_conditions.h"
 #include "chrome/browser/devtools/devtools_network_controller_handle.h"
 #include "chrome/browser/history/history_service_factory.h"
@@ -314,15 +317,10 @@ void SetCertVerifyProcInIO(
 void ClearHostResolverCacheInIO(
     const scoped_refptr<net::URLRequestContextGetter>& context_getter,
     const base::Closure& callback) {
-  auto request_context = context_getter->GetURLRequestContext();
-  auto cache = request_context->host_resolver()->GetHostCache();
-  if (cache) {
-    cache->clear();
-    DCHECK_EQ(0u, cache->size());
-    if (!callback.is_null())
-      BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-                              base::Bind(&base::DoNothing));
-  }
+  static_cast<brightray::URLRequestContextGetter*>(context_getter.get())->
+      ClearHostCache();
+  if (!callback.is_null())
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE, callback);
 }
 
 void AllowNTLMCredentialsForDomainsInIO(
@@ -517,6 +515,24 @@ void Session::ClearHostResolverCache(mate::Arguments* args) {
                  callback));
 }
 
+void Session::Preconnect(const GURL& url) {
+  auto predictor = brave::PreconnectPredictor::FromBrowserContext(profile_);
+  if (predictor)
+    predictor->PreconnectUrlAndSubresources(url);
+}
+
+void Session::Prefetch(const GURL& url, mate::Arguments* args) {
+  brave::NoStatePrefetcher::CompletionCallback callback;
+  args->GetNext(&callback);
+
+  auto prefetcher = brave::NoStatePrefetcher::FromBrowserContext(profile_);
+  if (!prefetcher) {
+    args->ThrowError("Prefetching is not available for this session");
+    return;
+  }
+  prefetcher->Prefetch(url, GURL(), callback);
+}
+
 void Session::AllowNTLMCredentialsForDomains(const std::string& domains) {
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
       base::Bind(&AllowNTLMCredentialsForDomainsInIO,
@@ -662,6 +678,8 @@ void Session::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setPermissionRequestHandler",
                  &Session::SetPermissionRequestHandler)
       .SetMethod("clearHostResolverCache", &Session::ClearHostResolverCache)
+      .SetMethod("preconnect", &Session::Preconnect)
+      .SetMethod("prefetch", &Session::Prefetch)
       .SetMethod("allowNTLMCredentialsForDomains",
                  &Session::AllowNTLMCredentialsForDomains)
       .SetMethod("setEnableBrotli", &Session::SetEnableBrotli)
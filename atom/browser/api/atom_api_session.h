@@ -80,6 +80,8 @@ class Session: public mate::TrackableObject<Session>,
   void SetPermissionRequestHandler(v8::Local<v8::Value> val,
                                    mate::Arguments* args);
   void ClearHostResolverCache(mate::Arguments* args);
+  void Preconnect(const GURL& url);
+  void Prefetch(const GURL& url, mate::Arguments* args);
   void AllowNTLMCredentialsForDomains(const std::string& domains);
   std::string Partition();
   void SetEnableBrotli(bool enabled);
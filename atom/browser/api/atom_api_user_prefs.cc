@@ -7,13 +7,17 @@
 
 #include "atom/browser/api/atom_api_user_prefs.h"
 
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "base/values.h"
+#include "brave/browser/app_state_store.h"
 #include "chrome/browser/profiles/profile.h"
 #include "components/pref_registry/pref_registry_syncable.h"
+#include "components/prefs/scoped_user_pref_update.h"
 #include "components/sync_preferences/pref_service_syncable.h"
 #include "content/public/browser/browser_thread.h"
+#include "native_mate/arguments.h"
 #include "native_mate/object_template_builder.h"
 
 namespace mate {
@@ -46,13 +50,31 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+// Reads the path of a value in a pref or the app state, either a single key
+// or an array of keys. An empty key or array addresses the whole value.
+bool GetPath(mate::Arguments* args, std::vector<std::string>* path) {
+  std::string key;
+  if (args->GetNext(&key)) {
+    if (!key.empty())
+      path->push_back(key);
+    return true;
+  }
+  return args->GetNext(path);
+}
+
+}  // namespace
+
 UserPrefs::UserPrefs(v8::Isolate* isolate,
                  content::BrowserContext* browser_context)
-      : browser_context_(browser_context) {
+      : browser_context_(browser_context),
+        observed_app_state_store_(nullptr) {
   Init(isolate);
 }
 
 UserPrefs::~UserPrefs() {
+  ObserveAppState(nullptr);
 }
 
 Profile* UserPrefs::profile() {
@@ -113,6 +135,11 @@ std::string UserPrefs::GetStringPref(const std::string& path) {
 
 const base::DictionaryValue* UserPrefs::GetDictionaryPref(
       const std::string& path) {
+  if (path == brave::kAppStatePrefName) {
+    brave::AppStateStore* store = app_state_store(false);
+    if (store)
+      return &store->state();
+  }
   return profile()->GetPrefs()->GetDictionary(path);
 }
 
@@ -139,6 +166,13 @@ void UserPrefs::SetStringPref(const std::string& path,
 
 void UserPrefs::SetDictionaryPref(const std::string& path,
     const base::DictionaryValue& value) {
+  if (path == brave::kAppStatePrefName) {
+    brave::AppStateStore* store = app_state_store(true);
+    if (store) {
+      store->Set(brave::AppStateStore::Path(), value.CreateDeepCopy());
+      return;
+    }
+  }
   profile()->GetPrefs()->Set(path, value);
 }
 
@@ -162,6 +196,276 @@ void UserPrefs::SetDoublePref(const std::string& path,
   profile()->GetPrefs()->SetDouble(path, value);
 }
 
+v8::Local<v8::Value> UserPrefs::GetPref(mate::Arguments* args) {
+  std::string name;
+  if (!args->GetNext(&name)) {
+    args->ThrowError("Expected a pref name");
+    return v8::Null(isolate());
+  }
+  if (name == brave::kAppStatePrefName)
+    return GetAppState(args);
+
+  std::vector<std::string> path;
+  GetPath(args, &path);
+
+  const PrefService::Preference* pref =
+      profile()->GetPrefs()->FindPreference(name);
+  if (!pref)
+    return v8::Null(isolate());
+
+  const base::Value* value = brave::FindValueAtPath(*pref->GetValue(), path);
+  if (!value)
+    return v8::Null(isolate());
+
+  std::unique_ptr<atom::V8ValueConverter>
+      converter(new atom::V8ValueConverter);
+  return converter->ToV8Value(value, isolate()->GetCurrentContext());
+}
+
+void UserPrefs::SetPref(mate::Arguments* args) {
+  std::string name;
+  if (!args->GetNext(&name)) {
+    args->ThrowError("Expected a pref name, a path and a value");
+    return;
+  }
+  if (name == brave::kAppStatePrefName) {
+    SetAppState(args);
+    return;
+  }
+
+  std::vector<std::string> path;
+  v8::Local<v8::Value> v8_value;
+  if (!GetPath(args, &path) || !args->GetNext(&v8_value)) {
+    args->ThrowError("Expected a pref name, a path and a value");
+    return;
+  }
+
+  std::unique_ptr<atom::V8ValueConverter>
+      converter(new atom::V8ValueConverter);
+  std::unique_ptr<base::Value> value(
+      converter->FromV8Value(v8_value, isolate()->GetCurrentContext()));
+  const PrefService::Preference* pref =
+      profile()->GetPrefs()->FindPreference(name);
+  if (!value || !pref) {
+    args->ThrowError("Invalid pref or value");
+    return;
+  }
+
+  if (path.empty()) {
+    // Whole numbers arrive as integers.
+    int integer;
+    if (pref->GetType() == base::Value::Type::DOUBLE &&
+        value->GetAsInteger(&integer))
+      value.reset(new base::Value(static_cast<double>(integer)));
+    if (pref->GetType() != value->GetType()) {
+      args->ThrowError("The value doesn't match the type of the pref");
+      return;
+    }
+    WillChangePref(name, path);
+    profile()->GetPrefs()->Set(name, *value);
+    DidChangePref(name);
+    return;
+  }
+
+  if (pref->GetType() != base::Value::Type::DICTIONARY) {
+    args->ThrowError("Only dictionary prefs have paths");
+    return;
+  }
+  WillChangePref(name, path);
+  {
+    DictionaryPrefUpdate update(profile()->GetPrefs(), name);
+    brave::SetValueAtPath(update.Get(), path, std::move(value));
+  }
+  DidChangePref(name);
+}
+
+void UserPrefs::RemovePref(mate::Arguments* args) {
+  std::string name;
+  if (!args->GetNext(&name)) {
+    args->ThrowError("Expected a pref name and a path");
+    return;
+  }
+  if (name == brave::kAppStatePrefName) {
+    RemoveAppState(args);
+    return;
+  }
+
+  std::vector<std::string> path;
+  if (!GetPath(args, &path) || path.empty()) {
+    args->ThrowError("Expected a pref name and a path");
+    return;
+  }
+
+  const PrefService::Preference* pref =
+      profile()->GetPrefs()->FindPreference(name);
+  if (!pref || pref->GetType() != base::Value::Type::DICTIONARY) {
+    args->ThrowError("Only dictionary prefs have paths");
+    return;
+  }
+  if (!brave::FindValueAtPath(*pref->GetValue(), path))
+    return;
+
+  WillChangePref(name, path);
+  {
+    DictionaryPrefUpdate update(profile()->GetPrefs(), name);
+    brave::SetValueAtPath(update.Get(), path, nullptr);
+  }
+  DidChangePref(name);
+}
+
+void UserPrefs::ObservePref(mate::Arguments* args) {
+  std::string name;
+  if (!args->GetNext(&name)) {
+    args->ThrowError("Expected a pref name");
+    return;
+  }
+
+  // Passing null as listener stops observing the pref.
+  PrefObserver observer;
+  if (!args->GetNext(&observer)) {
+    pref_observers_.erase(name);
+    changed_paths_.erase(name);
+    if (name == brave::kAppStatePrefName)
+      ObserveAppState(nullptr);
+    else if (registrar_.IsObserved(name))
+      registrar_.Remove(name);
+    return;
+  }
+
+  pref_observers_[name] = observer;
+  if (name == brave::kAppStatePrefName) {
+    ObserveAppState(app_state_store(false));
+    return;
+  }
+
+  if (registrar_.IsEmpty())
+    registrar_.Init(profile()->GetPrefs());
+  if (!registrar_.IsObserved(name)) {
+    registrar_.Add(name, base::Bind(&UserPrefs::OnPrefChanged,
+                                    base::Unretained(this)));
+  }
+}
+
+void UserPrefs::WillChangePref(const std::string& name,
+                               const std::vector<std::string>& path) {
+  if (pref_observers_.count(name))
+    changed_paths_[name].push_back(path);
+}
+
+void UserPrefs::DidChangePref(const std::string& name) {
+  // The observers were notified synchronously, if the value changed at all.
+  changed_paths_.erase(name);
+}
+
+void UserPrefs::OnPrefChanged(const std::string& name) {
+  auto observer = pref_observers_.find(name);
+  if (observer == pref_observers_.end())
+    return;
+
+  // Changes made through other APIs replace the whole pref.
+  std::vector<std::vector<std::string>> paths;
+  auto it = changed_paths_.find(name);
+  if (it != changed_paths_.end()) {
+    paths.swap(it->second);
+    changed_paths_.erase(it);
+  } else {
+    paths.push_back(std::vector<std::string>());
+  }
+  observer->second.Run(name, paths);
+}
+
+void UserPrefs::OnAppStateChanged(const brave::AppStateStore::Path& path) {
+  auto observer = pref_observers_.find(brave::kAppStatePrefName);
+  if (observer != pref_observers_.end())
+    observer->second.Run(brave::kAppStatePrefName,
+                         std::vector<std::vector<std::string>>(1, path));
+}
+
+void UserPrefs::ObserveAppState(brave::AppStateStore* store) {
+  if (observed_app_state_store_ == store)
+    return;
+  if (observed_app_state_store_)
+    observed_app_state_store_->RemoveObserver(this);
+  observed_app_state_store_ = store;
+  if (observed_app_state_store_)
+    observed_app_state_store_->AddObserver(this);
+}
+
+brave::AppStateStore* UserPrefs::app_state_store(bool writable) {
+  auto context = brave::BraveBrowserContext::FromBrowserContext(
+      browser_context_);
+  if (!writable)
+    return context->app_state_store();
+
+  // Off the record sessions get their own store once they change the state,
+  // the observers follow it there.
+  brave::AppStateStore* store = context->GetWritableAppStateStore();
+  if (observed_app_state_store_)
+    ObserveAppState(store);
+  return store;
+}
+
+v8::Local<v8::Value> UserPrefs::GetAppState(mate::Arguments* args) {
+  auto store = app_state_store(false);
+  if (!store) {
+    args->ThrowError("The app state is not available for this session");
+    return v8::Null(isolate());
+  }
+
+  brave::AppStateStore::Path path;
+  GetPath(args, &path);
+
+  const base::Value* value = store->Get(path);
+  if (!value)
+    return v8::Null(isolate());
+
+  std::unique_ptr<atom::V8ValueConverter>
+      converter(new atom::V8ValueConverter);
+  return converter->ToV8Value(value, isolate()->GetCurrentContext());
+}
+
+void UserPrefs::SetAppState(mate::Arguments* args) {
+  auto store = app_state_store(true);
+  if (!store) {
+    args->ThrowError("The app state is not available for this session");
+    return;
+  }
+
+  brave::AppStateStore::Path path;
+  v8::Local<v8::Value> v8_value;
+  if (!GetPath(args, &path) || !args->GetNext(&v8_value)) {
+    args->ThrowError("Expected a path and a value");
+    return;
+  }
+
+  std::unique_ptr<atom::V8ValueConverter>
+      converter(new atom::V8ValueConverter);
+  std::unique_ptr<base::Value> value(
+      converter->FromV8Value(v8_value, isolate()->GetCurrentContext()));
+  if (!value || (path.empty() &&
+                 !value->IsType(base::Value::Type::DICTIONARY))) {
+    args->ThrowError("Invalid app state value");
+    return;
+  }
+
+  store->Set(path, std::move(value));
+}
+
+void UserPrefs::RemoveAppState(mate::Arguments* args) {
+  auto store = app_state_store(true);
+  if (!store) {
+    args->ThrowError("The app state is not available for this session");
+    return;
+  }
+
+  brave::AppStateStore::Path path;
+  if (!GetPath(args, &path)) {
+    args->ThrowError("Expected a path");
+    return;
+  }
+  store->Remove(path);
+}
+
 double UserPrefs::GetDefaultZoomLevel() {
   return profile()->GetZoomLevelPrefs()->GetDefaultZoomLevelPref();
 }
@@ -208,6 +512,15 @@ void UserPrefs::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setDoublePref", &UserPrefs::SetDoublePref)
       // .SetMethod("setFilePathPref", &UserPrefs::SetFilePathPref)
 
+      .SetMethod("getPref", &UserPrefs::GetPref)
+      .SetMethod("setPref", &UserPrefs::SetPref)
+      .SetMethod("removePref", &UserPrefs::RemovePref)
+      .SetMethod("observePref", &UserPrefs::ObservePref)
+
+      .SetMethod("getAppState", &UserPrefs::GetAppState)
+      .SetMethod("setAppState", &UserPrefs::SetAppState)
+      .SetMethod("removeAppState", &UserPrefs::RemoveAppState)
+
       .SetMethod("getDefaultZoomLevel", &UserPrefs::GetDefaultZoomLevel)
       .SetMethod("setDefaultZoomLevel", &UserPrefs::SetDefaultZoomLevel);
 }
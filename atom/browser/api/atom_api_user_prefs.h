@@ -5,11 +5,15 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 #define ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
+#include "brave/browser/app_state_store.h"
 #include "brave/browser/brave_browser_context.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "native_mate/handle.h"
 
 namespace base {
@@ -17,13 +21,18 @@ class DictionaryValue;
 class ListValue;
 }
 
+namespace mate {
+class Arguments;
+}
+
 class Profile;
 
 namespace atom {
 
 namespace api {
 
-class UserPrefs : public mate::TrackableObject<UserPrefs> {
+class UserPrefs : public mate::TrackableObject<UserPrefs>,
+                  public brave::AppStateStore::Observer {
  public:
   static mate::Handle<UserPrefs> Create(v8::Isolate* isolate,
                                   content::BrowserContext* browser_context);
@@ -33,6 +42,9 @@ class UserPrefs : public mate::TrackableObject<UserPrefs> {
                              v8::Local<v8::FunctionTemplate> prototype);
 
  protected:
+  using PrefObserver = base::Callback<void(
+      const std::string&, const std::vector<std::vector<std::string>>&)>;
+
   UserPrefs(v8::Isolate* isolate, content::BrowserContext* browser_context);
   ~UserPrefs() override;
 
@@ -73,14 +85,52 @@ class UserPrefs : public mate::TrackableObject<UserPrefs> {
   void SetDefaultIntegerPref(const std::string& path, int value);
   void SetDefaultDoublePref(const std::string& path, double value);
 
+  // Read and write the entry at a path of a dictionary pref, or the whole
+  // pref if the path is empty, converting only that value. A path is a key
+  // or an array of keys, taken as they are so that dotted ones like
+  // hostnames can be used.
+  v8::Local<v8::Value> GetPref(mate::Arguments* args);
+  void SetPref(mate::Arguments* args);
+  void RemovePref(mate::Arguments* args);
+
+  // Calls the listener with the paths changed by each update of a pref or
+  // of the app state.
+  void ObservePref(mate::Arguments* args);
+
+  // Path-scoped access to the app state, which is persisted incrementally.
+  // A path is a key or an array of keys. The pref APIs forward the
+  // `app_state` pref here.
+  v8::Local<v8::Value> GetAppState(mate::Arguments* args);
+  void SetAppState(mate::Arguments* args);
+  void RemoveAppState(mate::Arguments* args);
+
   double GetDefaultZoomLevel();
   void SetDefaultZoomLevel(double zoom);
 
   Profile* profile();
 
  private:
+  brave::AppStateStore* app_state_store(bool writable);
+  void WillChangePref(const std::string& name,
+                      const std::vector<std::string>& path);
+  void DidChangePref(const std::string& name);
+  void OnPrefChanged(const std::string& name);
+
+  // brave::AppStateStore::Observer:
+  void OnAppStateChanged(const brave::AppStateStore::Path& path) override;
+
+  // Moves the app state observer to |store|, null to stop observing.
+  void ObserveAppState(brave::AppStateStore* store);
+
   content::BrowserContext* browser_context_;  // not owned
 
+  PrefChangeRegistrar registrar_;
+  std::map<std::string, PrefObserver> pref_observers_;
+  // The paths changed by the update of the observed prefs in progress.
+  std::map<std::string, std::vector<std::vector<std::string>>>
+      changed_paths_;
+  brave::AppStateStore* observed_app_state_store_;  // not owned
+
   DISALLOW_COPY_AND_ASSIGN(UserPrefs);
 };
 
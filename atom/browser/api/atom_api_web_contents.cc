@@ -10,6 +10,7 @@
 #include "atom/browser/api/atom_api_web_contents.h"
 
 #include "atom/browser/api/atom_api_debugger.h"
+#include "atom/browser/api/atom_api_objects_registry.h"
 #include "atom/browser/api/atom_api_session.h"
 #include "atom/browser/api/atom_api_web_request.h"
 #include "atom/browser/api/atom_api_window.h"
@@ -19,6 +20,7 @@
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/autofill/atom_autofill_client.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/ipc_stats.h"
 #include "atom/browser/lib/bluetooth_chooser.h"
 #include "atom/browser/native_window.h"
 #include "atom/browser/net/atom_network_delegate.h"
@@ -27,6 +29,7 @@
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/api/structured_clone.h"
 #include "atom/common/color_util.h"
 #include "atom/common/mouse_util.h"
 #include "atom/common/native_mate_converters/blink_converter.h"
@@ -40,11 +43,16 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
+#include "base/atomic_sequence_num.h"
+#include "base/auto_reset.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "brave/browser/brave_browser_context.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/browser/guest_view/tab_view/tab_view_guest.h"
+#include "brave/browser/net/no_state_prefetcher.h"
+#include "brave/browser/net/preconnect_predictor.h"
 #include "brave/browser/password_manager/brave_password_manager_client.h"
 #include "brave/browser/plugins/brave_plugin_service_filter.h"
 #include "brave/browser/renderer_preferences_helper.h"
@@ -318,6 +326,12 @@ namespace api {
 
 namespace {
 
+// The number of regions a renderer can have allocated for structured messages
+// without sending them yet.
+const size_t kMaxStructuredSharedMemory = 16;
+
+base::StaticAtomicSequenceNumber g_structured_shared_message_id;
+
 mate::Handle<api::Session> SessionFromOptions(v8::Isolate* isolate,
     const mate::Dictionary& options) {
   mate::Handle<api::Session> session;
@@ -355,6 +369,16 @@ content::ServiceWorkerContext* GetServiceWorkerContext(
   return storage_partition->GetServiceWorkerContext();
 }
 
+// The messages of ipcRenderer are sent on a few internal channels, with the
+// channel given by the user as their first argument.
+std::string GetUserChannel(const base::string16& channel,
+                           const base::ListValue& args) {
+  std::string user_channel;
+  if (!args.GetString(0, &user_channel))
+    user_channel = base::UTF16ToUTF8(channel);
+  return user_channel;
+}
+
 // Called when CapturePage is done.
 void OnCapturePageDone(base::Callback<void(const gfx::Image&)> callback,
                        const SkBitmap& bitmap,
@@ -372,6 +396,8 @@ WebContents::WebContents(v8::Isolate* isolate,
       request_id_(0),
       enable_devtools_(true),
       is_being_destroyed_(false),
+      incoming_message_size_(0),
+      next_structured_shared_memory_id_(0),
       guest_delegate_(nullptr) {
   if (type == REMOTE) {
     Init(isolate);
@@ -391,6 +417,8 @@ WebContents::WebContents(v8::Isolate* isolate,
     request_id_(0),
     enable_devtools_(true),
     is_being_destroyed_(false),
+    incoming_message_size_(0),
+    next_structured_shared_memory_id_(0),
     guest_delegate_(nullptr) {
   CreateWebContents(isolate, options, create_params);
 }
@@ -400,6 +428,8 @@ WebContents::WebContents(v8::Isolate* isolate, const mate::Dictionary& options)
       request_id_(0),
       enable_devtools_(true),
       is_being_destroyed_(false),
+      incoming_message_size_(0),
+      next_structured_shared_memory_id_(0),
       guest_delegate_(nullptr) {
   mate::Handle<api::Session> session = SessionFromOptions(isolate, options);
 
@@ -1171,6 +1201,14 @@ void WebContents::DidFailLoad(content::RenderFrameHost* render_frame_host,
 
 void WebContents::DidGetResourceResponseStart(
     const content::ResourceRequestDetails& details) {
+  if (details.resource_type != content::RESOURCE_TYPE_MAIN_FRAME) {
+    auto predictor = brave::PreconnectPredictor::FromBrowserContext(
+        web_contents()->GetBrowserContext());
+    if (predictor)
+      predictor->OnResourceLoaded(web_contents()->GetLastCommittedURL(),
+                                  details.url);
+  }
+
   const net::HttpResponseHeaders* headers = details.headers.get();
   Emit("did-get-response-details",
        details.socket_address.IsEmpty(),
@@ -1206,6 +1244,14 @@ void WebContents::DidStopLoading() {
 
 void WebContents::DidStartNavigation(
     content::NavigationHandle* navigation_handle) {
+  if (navigation_handle->IsInMainFrame() &&
+      !navigation_handle->IsSameDocument()) {
+    auto predictor = brave::PreconnectPredictor::FromBrowserContext(
+        web_contents()->GetBrowserContext());
+    if (predictor)
+      predictor->OnNavigationStarted(navigation_handle->GetURL());
+  }
+
   Emit("did-start-navigation", navigation_handle);
 
   // deprecated event handling
@@ -1318,9 +1364,20 @@ void WebContents::DevToolsClosed() {
 }
 
 bool WebContents::OnMessageReceived(const IPC::Message& message) {
+  base::AutoReset<size_t> incoming_message_size(&incoming_message_size_,
+                                                message.size());
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(WebContents, message)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message, OnRendererMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Dereference, OnDereference)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_SendTo,
+                        OnRendererMessageSendTo)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Structured,
+                        OnRendererMessageStructured)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_AllocateStructuredShared,
+                        OnAllocateStructuredShared)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Structured_Shared,
+                        OnRendererMessageStructuredShared)
     IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_Message_Sync,
                                     OnRendererMessageSync)
     IPC_MESSAGE_HANDLER_CODE(ViewHostMsg_SetCursor, OnCursorChange,
@@ -1391,6 +1448,9 @@ void WebContents::WebContentsDestroyed() {
   // being destroyed.
   Emit("will-destroy");
 
+  // Release the remote objects referenced by the renderer.
+  ObjectsRegistry::GetInstance()->Clear(GetID());
+
   // Cleanup relationships with other parts.
   RemoveFromWeakMap();
 
@@ -1418,6 +1478,10 @@ int WebContents::GetID() const {
 #endif
 }
 
+uint32_t WebContents::GetRemoteObjectCount() const {
+  return ObjectsRegistry::GetInstance()->GetCount(GetID());
+}
+
 WebContents::Type WebContents::GetType() const {
 #if BUILDFLAG(ENABLE_EXTENSIONS)
   if (brave::api::Extension::IsBackgroundPageWebContents(web_contents()))
@@ -1525,6 +1589,19 @@ void WebContents::DownloadURL(const GURL& url,
   download_manager->DownloadUrl(std::move(params));
 }
 
+void WebContents::Prefetch(const GURL& url, mate::Arguments* args) {
+  brave::NoStatePrefetcher::CompletionCallback callback;
+  args->GetNext(&callback);
+
+  auto prefetcher = brave::NoStatePrefetcher::FromBrowserContext(
+      web_contents()->GetBrowserContext());
+  if (!prefetcher) {
+    args->ThrowError("Prefetching is not available for this webContents");
+    return;
+  }
+  prefetcher->Prefetch(url, web_contents()->GetLastCommittedURL(), callback);
+}
+
 GURL WebContents::GetURL() const {
   return web_contents()->GetURL();
 }
@@ -2056,18 +2133,61 @@ bool WebContents::ExecuteScriptInTab(mate::Arguments* args) {
 
 bool WebContents::SendIPCSharedMemory(const base::string16& channel,
                                       base::SharedMemory* shared_memory) {
+  IPCStats::Recorder recorder(IPCStats::BROWSER_TO_RENDERER, 0);
   base::SharedMemoryHandle memory_handle = shared_memory->handle().Duplicate();
   if (!memory_handle.IsValid())
     return false;
 
-  return Send(
+  return SendIPC(channel, &recorder, shared_memory->requested_size(),
       new AtomViewMsg_Message_Shared(routing_id(), channel, memory_handle));
 }
 
 bool WebContents::SendIPCMessage(bool all_frames,
                                  const base::string16& channel,
                                  const base::ListValue& args) {
-  return Send(new AtomViewMsg_Message(routing_id(), all_frames, channel, args));
+  IPCStats::Recorder recorder(IPCStats::BROWSER_TO_RENDERER, 0);
+  return SendIPC(channel, &recorder, 0,
+      new AtomViewMsg_Message(routing_id(), all_frames, channel, args));
+}
+
+bool WebContents::SendIPC(const base::string16& channel,
+                          IPCStats::Recorder* recorder,
+                          size_t shared_memory_size,
+                          IPC::Message* message) {
+  TRACE_EVENT1("ipc", "WebContents::SendIPC",
+               "channel", base::UTF16ToUTF8(channel));
+  if (recorder->is_recording()) {
+    recorder->set_channel(base::UTF16ToUTF8(channel));
+    recorder->set_bytes(message->size() + shared_memory_size);
+  }
+  return Send(message);
+}
+
+bool WebContents::SendIPCStructured(bool all_frames,
+                                    const base::string16& channel,
+                                    v8::Local<v8::Value> args) {
+  IPCStats::Recorder recorder(IPCStats::BROWSER_TO_RENDERER, 0);
+  // A DataCloneError has been thrown if |args| can't be serialized.
+  std::vector<uint8_t> data;
+  if (!SerializeV8Value(isolate(), args, &data))
+    return false;
+
+  if (data.size() < kStructuredCloneSharedMemoryThreshold) {
+    return SendIPC(channel, &recorder, 0,
+        new AtomViewMsg_Message_Structured(
+            routing_id(), all_frames, channel, data));
+  }
+
+  base::SharedMemory shared_memory;
+  base::SharedMemoryHandle handle;
+  if (!shared_memory.CreateAnonymous(data.size()) ||
+      !CopyToSharedMemory(data, &shared_memory, &handle))
+    return false;
+
+  return SendIPC(channel, &recorder, data.size(),
+      new AtomViewMsg_Message_Structured_Shared(
+          routing_id(), all_frames, channel,
+          g_structured_shared_message_id.GetNext(), handle, data.size()));
 }
 
 void WebContents::SendInputEvent(v8::Isolate* isolate,
@@ -2186,6 +2306,9 @@ void WebContents::GetPreferredSize(mate::Arguments* args) {
 }
 
 void WebContents::OnCursorChange(const content::WebCursor& cursor) {
+  if (!HasListeners("cursor-changed"))
+    return;
+
   content::CursorInfo info;
   cursor.GetCursorInfo(&info);
 
@@ -2324,10 +2447,15 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .MakeDestroyable()
       .SetMethod("getId", &WebContents::GetID)
+      .SetMethod("getRemoteObjectCount", &WebContents::GetRemoteObjectCount)
+      .SetMethod("_setListeners", &WebContents::SetListeners)
+      .SetMethod("_setListening", &WebContents::SetListening)
+      .SetMethod("setEventCoalescing", &WebContents::SetEventCoalescing)
       .SetMethod("equal", &WebContents::Equal)
       .SetMethod("_loadURL", &WebContents::LoadURL)
       .SetMethod("_reload", &WebContents::Reload)
       .SetMethod("downloadURL", &WebContents::DownloadURL)
+      .SetMethod("prefetch", &WebContents::Prefetch)
       .SetMethod("getURL", &WebContents::GetURL)
       .SetMethod("getTitle", &WebContents::GetTitle)
       .SetMethod("isInitialBlankNavigation",
@@ -2384,6 +2512,7 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("_clone", &WebContents::Clone)
       .SetMethod("_send", &WebContents::SendIPCMessage)
       .SetMethod("_sendShared", &WebContents::SendIPCSharedMemory)
+      .SetMethod("_sendStructured", &WebContents::SendIPCStructured)
       .SetMethod("sendInputEvent", &WebContents::SendInputEvent)
       .SetMethod("startDrag", &WebContents::StartDrag)
       .SetMethod("setSize", &WebContents::SetSize)
@@ -2461,13 +2590,135 @@ AtomBrowserContext* WebContents::GetBrowserContext() const {
 
 void WebContents::OnRendererMessage(const base::string16& channel,
                                     const base::ListValue& args) {
+  TRACE_EVENT1("ipc", "WebContents::OnRendererMessage",
+               "channel", GetUserChannel(channel, args));
+  IPCStats::Recorder recorder(IPCStats::RENDERER_TO_BROWSER,
+                              incoming_message_size_);
+  if (recorder.is_recording())
+    recorder.set_channel(GetUserChannel(channel, args));
   // webContents.emit(channel, new Event(), args...);
   Emit(base::UTF16ToUTF8(channel), args);
 }
 
+void WebContents::OnDereference(const std::map<int32_t, int32_t>& counts) {
+  ObjectsRegistry* registry = ObjectsRegistry::GetInstance();
+  int32_t owner_id = GetID();
+  for (const auto& it : counts)
+    registry->Remove(owner_id, it.first, it.second);
+}
+
+void WebContents::OnRendererMessageSendTo(bool send_to_all,
+                                          int32_t web_contents_id,
+                                          const base::string16& channel,
+                                          const base::ListValue& args) {
+  TRACE_EVENT1("ipc", "WebContents::OnRendererMessageSendTo",
+               "channel", base::UTF16ToUTF8(channel));
+  IPCStats::Recorder recorder(IPCStats::RENDERER_TO_BROWSER,
+                              incoming_message_size_);
+  if (recorder.is_recording())
+    recorder.set_channel(base::UTF16ToUTF8(channel));
+  // The arguments are forwarded as they are, without being converted to V8.
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  WebContents* target = FromWeakMapID(isolate(), web_contents_id);
+  if (target)
+    target->SendIPCMessage(send_to_all, channel, args);
+}
+
+void WebContents::OnRendererMessageStructured(
+    const base::string16& channel,
+    const std::vector<uint8_t>& args) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  EmitStructuredMessage(channel, DeserializeV8Value(isolate(), args));
+}
+
+void WebContents::OnAllocateStructuredShared(
+    uint32_t size,
+    int32_t* id,
+    base::SharedMemoryHandle* handle) {
+  *id = 0;
+  if (size < kStructuredCloneSharedMemoryThreshold ||
+      size > kMaxStructuredCloneSize ||
+      structured_shared_memory_.size() >= kMaxStructuredSharedMemory)
+    return;
+
+  std::unique_ptr<base::SharedMemory> shared_memory(new base::SharedMemory);
+  if (!shared_memory->CreateAnonymous(size))
+    return;
+  *handle = shared_memory->handle().Duplicate();
+  if (!handle->IsValid())
+    return;
+
+  *id = ++next_structured_shared_memory_id_;
+  structured_shared_memory_[*id] = std::move(shared_memory);
+}
+
+void WebContents::OnRendererMessageStructuredShared(
+    const base::string16& channel,
+    int32_t id,
+    uint32_t size) {
+  auto it = structured_shared_memory_.find(id);
+  if (it == structured_shared_memory_.end()) {
+    LOG(ERROR) << "Invalid AtomViewHostMsg_Message_Structured_Shared memory";
+    return;
+  }
+  std::unique_ptr<base::SharedMemory> shared_memory = std::move(it->second);
+  structured_shared_memory_.erase(it);
+
+  // The size is checked against the memory that was allocated.
+  if (size == 0 || size > shared_memory->requested_size())
+    return;
+
+  // The message only carries the id, count the shared memory too.
+  base::AutoReset<size_t> incoming_message_size(
+      &incoming_message_size_, incoming_message_size_ + size);
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  EmitStructuredMessage(channel,
+                        DeserializeV8Value(isolate(), shared_memory.get(),
+                                           size));
+}
+
+void WebContents::EmitStructuredMessage(const base::string16& channel,
+                                        v8::MaybeLocal<v8::Value> args) {
+  v8::Local<v8::Value> value;
+  if (!args.ToLocal(&value) || !value->IsArray()) {
+    LOG(ERROR) << "Invalid AtomViewHostMsg_Message_Structured arguments";
+    return;
+  }
+
+  IPCStats::Recorder recorder(IPCStats::RENDERER_TO_BROWSER,
+                              incoming_message_size_);
+  bool tracing = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED("ipc", &tracing);
+  std::string user_channel;
+  if ((tracing || recorder.is_recording()) &&
+      !mate::ConvertFromV8(isolate(),
+                           value.As<v8::Array>()->Get(0), &user_channel))
+    user_channel = base::UTF16ToUTF8(channel);
+  TRACE_EVENT1("ipc", "WebContents::OnRendererMessageStructured",
+               "channel", user_channel);
+  recorder.set_channel(user_channel);
+  // webContents.emit(channel, new Event(), args);
+  Emit(base::UTF16ToUTF8(channel), value);
+}
+
 void WebContents::OnRendererMessageSync(const base::string16& channel,
                                         const base::ListValue& args,
                                         IPC::Message* message) {
+  IPCStats::Recorder recorder(IPCStats::RENDERER_TO_BROWSER_SYNC,
+                              incoming_message_size_);
+  bool tracing = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED("ipc", &tracing);
+  std::string user_channel;
+  if (tracing || recorder.is_recording())
+    user_channel = GetUserChannel(channel, args);
+  TRACE_EVENT1("ipc", "WebContents::OnRendererMessageSync",
+               "channel", user_channel);
+  recorder.set_channel(user_channel);
+  // The renderer is blocked until the reply is sent by the event.
+  IPCStats::GetInstance()->BeginSync(message, user_channel);
   // webContents.emit(channel, new Event(sender, message), args...);
   EmitWithSender(base::UTF16ToUTF8(channel), web_contents(), message, args);
 }
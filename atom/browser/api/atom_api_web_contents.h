@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 #define ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -12,8 +13,11 @@
 #include "atom/browser/api/save_page_handler.h"
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/common_web_contents_delegate.h"
+#include "atom/browser/ipc_stats.h"
 #include "atom/common/options_switches.h"
 #include "base/memory/memory_pressure_listener.h"
+#include "base/memory/shared_memory_handle.h"
+#include "base/time/time.h"
 #include "chrome/browser/ui/tabs/tab_strip_model_observer.h"
 #include "content/common/cursors/webcursor.h"
 #include "content/common/view_messages.h"
@@ -148,12 +152,16 @@ class WebContents : public mate::TrackableObject<WebContents>,
                       NativeWindow* owner_window) override;
 
   int GetID() const;
+  // Returns the number of main process objects the renderer holds through
+  // the remote module.
+  uint32_t GetRemoteObjectCount() const;
   Type GetType() const;
   int GetGuestInstanceId() const;
   bool Equal(const WebContents* web_contents) const;
   void LoadURL(const GURL& url, const mate::Dictionary& options);
   void Reload(bool ignore_cache);
   void DownloadURL(const GURL& url, bool prompt_for_location = false);
+  void Prefetch(const GURL& url, mate::Arguments* args);
   GURL GetURL() const;
   base::string16 GetTitle() const;
   bool IsInitialBlankNavigation() const;
@@ -257,6 +265,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
                       const base::ListValue& args);
   bool SendIPCSharedMemory(const base::string16& channel,
                             base::SharedMemory* shared_memory);
+  bool SendIPCStructured(bool all_frames,
+                         const base::string16& channel,
+                         v8::Local<v8::Value> args);
 
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
@@ -504,6 +515,14 @@ class WebContents : public mate::TrackableObject<WebContents>,
     return ++request_id_;
   }
 
+  // Sends |message| and counts it with |recorder|, with the
+  // |shared_memory_size| bytes it carries out of band, in the IPC stats of
+  // |channel|.
+  bool SendIPC(const base::string16& channel,
+               IPCStats::Recorder* recorder,
+               size_t shared_memory_size,
+               IPC::Message* message);
+
   // Called when we receive a CursorChange message from chromium.
   void OnCursorChange(const content::WebCursor& cursor);
 
@@ -511,6 +530,27 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void OnRendererMessage(const base::string16& channel,
                          const base::ListValue& args);
 
+  // Called when the renderer released remote objects.
+  void OnDereference(const std::map<int32_t, int32_t>& counts);
+
+  // Called when received a message for another WebContents.
+  void OnRendererMessageSendTo(bool send_to_all,
+                               int32_t web_contents_id,
+                               const base::string16& channel,
+                               const base::ListValue& args);
+
+  // Called when received a message serialized by v8::ValueSerializer.
+  void OnRendererMessageStructured(const base::string16& channel,
+                                   const std::vector<uint8_t>& args);
+  void OnAllocateStructuredShared(uint32_t size,
+                                  int32_t* id,
+                                  base::SharedMemoryHandle* handle);
+  void OnRendererMessageStructuredShared(const base::string16& channel,
+                                         int32_t id,
+                                         uint32_t size);
+  void EmitStructuredMessage(const base::string16& channel,
+                             v8::MaybeLocal<v8::Value> args);
+
   // Called when received a synchronous message from renderer.
   void OnRendererMessageSync(const base::string16& channel,
                              const base::ListValue& args,
@@ -531,6 +571,15 @@ class WebContents : public mate::TrackableObject<WebContents>,
 
   bool is_being_destroyed_;
 
+  // Size of the message being dispatched by OnMessageReceived.
+  size_t incoming_message_size_;
+
+  // The shared memory allocated for the structured messages the renderer is
+  // about to send, by id.
+  std::map<int32_t, std::unique_ptr<base::SharedMemory>>
+      structured_shared_memory_;
+  int32_t next_structured_shared_memory_id_;
+
   guest_view::GuestViewBase* guest_delegate_;  // not owned
 
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
@@ -4,8 +4,11 @@
 
 #include "atom/browser/api/event.h"
 
+#include <vector>
+
+#include "atom/browser/ipc_stats.h"
 #include "atom/common/api/api_messages.h"
-#include "atom/common/native_mate_converters/string16_converter.h"
+#include "atom/common/api/structured_clone.h"
 #include "content/public/browser/web_contents.h"
 #include "native_mate/object_template_builder.h"
 
@@ -18,6 +21,8 @@ Event::Event(v8::Isolate* isolate)
 }
 
 Event::~Event() {
+  if (message_)
+    atom::IPCStats::GetInstance()->EndSync(message_, false);
 }
 
 void Event::SetSenderAndMessage(content::WebContents* sender,
@@ -31,6 +36,8 @@ void Event::SetSenderAndMessage(content::WebContents* sender,
 }
 
 void Event::WebContentsDestroyed() {
+  if (message_)
+    atom::IPCStats::GetInstance()->EndSync(message_, false);
   sender_ = nullptr;
   message_ = nullptr;
 }
@@ -40,11 +47,18 @@ void Event::PreventDefault(v8::Isolate* isolate) {
                            v8::True(isolate));
 }
 
-bool Event::SendReply(const base::string16& json) {
+bool Event::SendReply(v8::Isolate* isolate, v8::Local<v8::Value> result) {
   if (message_ == nullptr || sender_ == nullptr)
     return false;
 
-  AtomViewHostMsg_Message_Sync::WriteReplyParams(message_, json);
+  // A DataCloneError has been thrown if |result| can't be serialized, the
+  // message is kept so that another reply can still be sent.
+  std::vector<uint8_t> data;
+  if (!atom::SerializeV8Value(isolate, result, &data))
+    return false;
+
+  AtomViewHostMsg_Message_Sync::WriteReplyParams(message_, data);
+  atom::IPCStats::GetInstance()->EndSync(message_, true);
   bool success = sender_->Send(message_);
   message_ = nullptr;
   sender_ = nullptr;
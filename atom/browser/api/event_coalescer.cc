@@ -0,0 +1,155 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/event_coalescer.h"
+
+#include <utility>
+
+#include "atom/common/api/event_emitter_caller.h"
+#include "base/bind.h"
+#include "base/timer/timer.h"
+#include "native_mate/arguments.h"
+#include "native_mate/dictionary.h"
+#include "native_mate/wrappable_base.h"
+
+namespace mate {
+
+struct EventCoalescer::Stream {
+  base::TimeDelta interval;
+  bool batch = false;
+  base::TimeTicks last_delivery;
+  base::OneShotTimer timer;
+  // The event object followed by the arguments of each emission.
+  std::vector<std::vector<v8::Global<v8::Value>>> pending;
+};
+
+EventCoalescer::EventCoalescer(WrappableBase* emitter)
+    : emitter_(emitter),
+      weak_factory_(this) {
+}
+
+EventCoalescer::~EventCoalescer() {
+}
+
+void EventCoalescer::SetCoalescing(const std::string& name, Arguments* args) {
+  Dictionary options = Dictionary::CreateEmpty(args->isolate());
+  args->GetNext(&options);
+
+  int interval = 0;
+  std::string mode = "latest";
+  options.Get("interval", &interval);
+  options.Get("mode", &mode);
+  if (mode != "latest" && mode != "batch") {
+    args->ThrowError("Invalid `mode`");
+    return;
+  }
+
+  if (interval <= 0) {
+    // The events already held back are still delivered.
+    base::WeakPtr<EventCoalescer> self = weak_factory_.GetWeakPtr();
+    Deliver(name);
+    if (self)
+      streams_.erase(name);
+    return;
+  }
+
+  std::unique_ptr<Stream>& stream = streams_[name];
+  if (!stream)
+    stream.reset(new Stream);
+  stream->interval = base::TimeDelta::FromMilliseconds(interval);
+  stream->batch = mode == "batch";
+  if (!stream->batch && stream->pending.size() > 1)
+    stream->pending.erase(stream->pending.begin(), stream->pending.end() - 1);
+}
+
+bool EventCoalescer::IsCoalesced(const base::StringPiece& name) const {
+  return streams_.find(name.as_string()) != streams_.end();
+}
+
+void EventCoalescer::Add(const base::StringPiece& name,
+                         const std::vector<v8::Local<v8::Value>>& args) {
+  std::string key = name.as_string();
+  auto it = streams_.find(key);
+  if (it == streams_.end())
+    return;
+
+  Stream* stream = it->second.get();
+  if (!stream->batch)
+    stream->pending.clear();
+  std::vector<v8::Global<v8::Value>> entry;
+  for (const auto& arg : args)
+    entry.emplace_back(emitter_->isolate(), arg);
+  stream->pending.push_back(std::move(entry));
+
+  if (stream->timer.IsRunning())
+    return;
+
+  // The first event after a quiet interval is delivered right away.
+  base::TimeDelta delay =
+      stream->last_delivery + stream->interval - base::TimeTicks::Now();
+  if (delay <= base::TimeDelta()) {
+    Deliver(key);
+    return;
+  }
+  stream->timer.Start(FROM_HERE, delay,
+                      base::Bind(&EventCoalescer::Deliver,
+                                 base::Unretained(this), key));
+}
+
+bool EventCoalescer::Flush() {
+  std::vector<std::string> names;
+  for (const auto& it : streams_) {
+    if (!it.second->pending.empty())
+      names.push_back(it.first);
+  }
+
+  base::WeakPtr<EventCoalescer> self = weak_factory_.GetWeakPtr();
+  for (const auto& name : names) {
+    Deliver(name);
+    if (!self)
+      return false;
+  }
+  return true;
+}
+
+void EventCoalescer::Deliver(const std::string& name) {
+  auto it = streams_.find(name);
+  if (it == streams_.end() || it->second->pending.empty())
+    return;
+
+  Stream* stream = it->second.get();
+  stream->timer.Stop();
+  stream->last_delivery = base::TimeTicks::Now();
+  std::vector<std::vector<v8::Global<v8::Value>>> pending;
+  pending.swap(stream->pending);
+
+  v8::Isolate* isolate = emitter_->isolate();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Object> wrapper = emitter_->GetWrapper();
+  if (wrapper.IsEmpty())
+    return;
+
+  // this.emit(name, event, args...) with the latest emission, or
+  // this.emit(name, event, [[args...], ...]) with all of them.
+  internal::ValueVector args;
+  if (!stream->batch) {
+    for (const auto& arg : pending.back())
+      args.push_back(arg.Get(isolate));
+  } else {
+    args.push_back(pending.back().front().Get(isolate));
+    v8::Local<v8::Array> batch = v8::Array::New(isolate, pending.size());
+    for (size_t i = 0; i < pending.size(); ++i) {
+      v8::Local<v8::Array> entry =
+          v8::Array::New(isolate, pending[i].size() - 1);
+      for (size_t j = 1; j < pending[i].size(); ++j)
+        entry->Set(j - 1, pending[i][j].Get(isolate));
+      batch->Set(i, entry);
+    }
+    args.push_back(batch);
+  }
+  EmitEvent(isolate, wrapper, name, args);
+}
+
+}  // namespace mate
@@ -0,0 +1,65 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_EVENT_COALESCER_H_
+#define ATOM_BROWSER_API_EVENT_COALESCER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "v8/include/v8.h"
+
+namespace mate {
+
+class Arguments;
+class WrappableBase;
+
+// Delivers the events of an emitter at most once per interval, either the
+// latest one or all of them in a batch, so that a stream of events costs a
+// bounded number of calls to JavaScript.
+//
+// Owned by the emitter, which flushes the pending events before emitting any
+// other event so that listeners still see them in order.
+class EventCoalescer {
+ public:
+  explicit EventCoalescer(WrappableBase* emitter);
+  ~EventCoalescer();
+
+  // Reads the `interval` and `mode` options of |name| from |args|, an
+  // interval of 0 stops coalescing it.
+  void SetCoalescing(const std::string& name, Arguments* args);
+
+  bool IsCoalesced(const base::StringPiece& name) const;
+
+  // Keeps the event object and arguments in |args| to be delivered with the
+  // next emission of |name|.
+  void Add(const base::StringPiece& name,
+           const std::vector<v8::Local<v8::Value>>& args);
+
+  // Delivers the pending events of every stream now. Returns false if a
+  // listener destroyed the emitter, and |this| with it.
+  bool Flush();
+
+ private:
+  struct Stream;
+
+  void Deliver(const std::string& name);
+
+  WrappableBase* emitter_;  // not owned
+  std::map<std::string, std::unique_ptr<Stream>> streams_;
+
+  base::WeakPtrFactory<EventCoalescer> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventCoalescer);
+};
+
+}  // namespace mate
+
+#endif  // ATOM_BROWSER_API_EVENT_COALESCER_H_
@@ -5,9 +5,14 @@
 #ifndef ATOM_BROWSER_API_EVENT_EMITTER_H_
 #define ATOM_BROWSER_API_EVENT_EMITTER_H_
 
+#include <memory>
+#include <set>
+#include <string>
 #include <vector>
 
+#include "atom/browser/api/event_coalescer.h"
 #include "atom/common/api/event_emitter_caller.h"
+#include "native_mate/arguments.h"
 #include "native_mate/wrappable.h"
 
 namespace content {
@@ -50,6 +55,8 @@ class EventEmitter : public Wrappable<T> {
   bool EmitCustomEvent(const base::StringPiece& name,
                        v8::Local<v8::Object> event,
                        const Args&... args) {
+    if (!HasListeners(name))
+      return false;
     return EmitWithEvent(
         name,
         internal::CreateCustomEvent(isolate(), GetWrapper(), event), args...);
@@ -60,11 +67,51 @@ class EventEmitter : public Wrappable<T> {
   bool EmitWithFlags(const base::StringPiece& name,
                      int flags,
                      const Args&... args) {
+    if (!HasListeners(name))
+      return false;
     return EmitCustomEvent(
         name,
         internal::CreateEventFromFlags(isolate(), flags), args...);
   }
 
+  // Whether emitting |name| would call any listener. The arguments of an
+  // event can be expensive to convert, callers with an unusual amount of
+  // work to do before emitting can check it first.
+  bool HasListeners(const base::StringPiece& name) const {
+    return !listened_events_ ||
+           listened_events_->count(name.as_string()) > 0;
+  }
+
+  // Called by JavaScript to keep the events with listeners up to date, once
+  // it has called SetListeners the other events are not emitted at all.
+  void SetListeners(const std::vector<std::string>& names) {
+    listened_events_.reset(new std::set<std::string>(names.begin(),
+                                                     names.end()));
+  }
+  void SetListening(const std::string& name, bool listening) {
+    if (!listened_events_)
+      return;
+    if (listening)
+      listened_events_->insert(name);
+    else
+      listened_events_->erase(name);
+  }
+
+  // Called by JavaScript to deliver |name| at most once per interval, see
+  // EventCoalescer.
+  void SetEventCoalescing(const std::string& name, Arguments* args) {
+    if (!coalescer_)
+      coalescer_.reset(new EventCoalescer(this));
+    coalescer_->SetCoalescing(name, args);
+  }
+
+  // Delivers the events held back by the coalescer, for emitters about to
+  // be destroyed. Returns false if a listener destroyed the emitter, which
+  // must not be used then.
+  bool FlushCoalescedEvents() {
+    return !coalescer_ || coalescer_->Flush();
+  }
+
   // this.emit(name, new Event(), args...);
   template<typename... Args>
   bool Emit(const base::StringPiece& name, const Args&... args) {
@@ -77,6 +124,8 @@ class EventEmitter : public Wrappable<T> {
                       content::WebContents* sender,
                       IPC::Message* message,
                       const Args&... args) {
+    if (!HasListeners(name))
+      return false;
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
     v8::Local<v8::Object> wrapper = GetWrapper();
@@ -84,6 +133,9 @@ class EventEmitter : public Wrappable<T> {
       return false;
     v8::Local<v8::Object> event = internal::CreateJSEvent(
         isolate(), wrapper, sender, message);
+    // A synchronous message must be replied, it can't be held back.
+    if (message)
+      return EmitWithEventNow(name, event, args...);
     return EmitWithEvent(name, event, args...);
   }
 
@@ -91,18 +143,40 @@ class EventEmitter : public Wrappable<T> {
   EventEmitter() {}
 
  private:
-  // this.emit(name, event, args...);
+  // this.emit(name, event, args...), unless |name| is coalesced.
   template<typename... Args>
   bool EmitWithEvent(const base::StringPiece& name,
                      v8::Local<v8::Object> event,
                      const Args&... args) {
+    if (coalescer_ && coalescer_->IsCoalesced(name)) {
+      v8::Locker locker(isolate());
+      v8::HandleScope handle_scope(isolate());
+      // A coalesced event can't be prevented.
+      coalescer_->Add(name, { event, ConvertToV8(isolate(), args)... });
+      return false;
+    }
+    return EmitWithEventNow(name, event, args...);
+  }
+
+  // this.emit(name, event, args...), after the events held back so far.
+  template<typename... Args>
+  bool EmitWithEventNow(const base::StringPiece& name,
+                        v8::Local<v8::Object> event,
+                        const Args&... args) {
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
+    if (!FlushCoalescedEvents())
+      return false;
     EmitEvent(isolate(), GetWrapper(), name, event, args...);
     return event->Get(
         StringToV8(isolate(), "defaultPrevented"))->BooleanValue();
   }
 
+  // Events with listeners, all events are emitted when it is null.
+  std::unique_ptr<std::set<std::string>> listened_events_;
+
+  std::unique_ptr<EventCoalescer> coalescer_;
+
   DISALLOW_COPY_AND_ASSIGN(EventEmitter);
 };
 
@@ -61,10 +61,15 @@ AtomBrowserContext::AtomBrowserContext(
     const std::string& partition, bool in_memory,
     const base::DictionaryValue& options)
     : brightray::BrowserContext(partition, in_memory),
+      cookie_delegate_(new AtomCookieDelegate),
       network_delegate_(new AtomNetworkDelegate) {
   // Read options.
   use_cache_ = true;
   options.GetBoolean("cache", &use_cache_);
+  use_async_dns_ = false;
+  options.GetBoolean("asyncDns", &use_async_dns_);
+  persist_host_cache_ = false;
+  options.GetBoolean("persistHostCache", &persist_host_cache_);
 
   // Initialize Pref Registry in brightray.
   // InitPrefs();
@@ -159,6 +164,18 @@ std::vector<std::string> AtomBrowserContext::GetCookieableSchemes() {
   return default_schemes;
 }
 
+bool AtomBrowserContext::UseAsyncDns() {
+  return use_async_dns_;
+}
+
+bool AtomBrowserContext::PersistHostCache() {
+  return persist_host_cache_;
+}
+
+net::CookieMonsterDelegate* AtomBrowserContext::CreateCookieDelegate() {
+  return cookie_delegate_.get();
+}
+
 void AtomBrowserContext::RegisterPrefs(PrefRegistrySimple* pref_registry) {
   pref_registry->RegisterFilePathPref(prefs::kSelectFileLastDirectory,
                                       base::FilePath());
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "atom/browser/net/atom_cookie_delegate.h"
 #include "atom/browser/net/atom_network_delegate.h"
 #include "brightray/browser/browser_context.h"
 
@@ -35,6 +36,9 @@ class AtomBrowserContext : public brightray::BrowserContext {
   std::unique_ptr<net::CertVerifier> CreateCertVerifier() override;
   net::SSLConfigService* CreateSSLConfigService() override;
   std::vector<std::string> GetCookieableSchemes() override;
+  bool UseAsyncDns() override;
+  bool PersistHostCache() override;
+  net::CookieMonsterDelegate* CreateCookieDelegate() override;
 
   // content::BrowserContext:
   content::DownloadManagerDelegate* GetDownloadManagerDelegate() override;
@@ -45,6 +49,8 @@ class AtomBrowserContext : public brightray::BrowserContext {
 
   virtual AtomNetworkDelegate* network_delegate() {
       return network_delegate_; }
+  AtomCookieDelegate* cookie_delegate() const {
+      return cookie_delegate_.get(); }
 
  protected:
   AtomBrowserContext(const std::string& partition, bool in_memory,
@@ -55,6 +61,9 @@ class AtomBrowserContext : public brightray::BrowserContext {
   std::unique_ptr<AtomDownloadManagerDelegate> download_manager_delegate_;
   std::unique_ptr<AtomPermissionManager> permission_manager_;
   bool use_cache_;
+  bool use_async_dns_;
+  bool persist_host_cache_;
+  scoped_refptr<AtomCookieDelegate> cookie_delegate_;
 
   // Managed by brightray::BrowserContext.
   AtomNetworkDelegate* network_delegate_;
@@ -168,6 +168,8 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
 
   js_env_.reset(new JavascriptEnvironment);
   js_env_->isolate()->Enter();
+  // Atomics.wait would block the UI thread, it throws instead.
+  js_env_->isolate()->SetAllowAtomicsWait(false);
 
   node_bindings_->Initialize();
 
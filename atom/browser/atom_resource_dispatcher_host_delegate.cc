@@ -10,9 +10,14 @@
 #include "atom/browser/web_contents_permission_helper.h"
 #include "atom/common/platform_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "brave/browser/net/no_state_prefetcher.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/resource_request_info.h"
+#include "content/public/browser/resource_throttle.h"
 #include "net/base/escape.h"
 #include "net/ssl/client_cert_store.h"
+#include "net/url_request/url_request.h"
 #include "url/gurl.h"
 
 #if defined(USE_NSS_CERTS)
@@ -59,6 +64,22 @@ void HandleExternalProtocolInUI(
   permission_helper->RequestOpenExternalPermission(callback, has_user_gesture);
 }
 
+void PrefetchInUI(int render_process_id,
+                  const GURL& url,
+                  const GURL& referrer) {
+  content::RenderProcessHost* host =
+      content::RenderProcessHost::FromID(render_process_id);
+  if (!host)
+    return;
+
+  auto prefetcher =
+      brave::NoStatePrefetcher::FromBrowserContext(host->GetBrowserContext());
+  if (prefetcher) {
+    prefetcher->Prefetch(url, referrer,
+                         brave::NoStatePrefetcher::CompletionCallback());
+  }
+}
+
 }  // namespace
 
 AtomResourceDispatcherHostDelegate::AtomResourceDispatcherHostDelegate() {
@@ -97,4 +118,28 @@ AtomResourceDispatcherHostDelegate::CreateClientCertStore(
   #endif
 }
 
+void AtomResourceDispatcherHostDelegate::RequestBeginning(
+    net::URLRequest* request,
+    content::ResourceContext* resource_context,
+    content::AppCacheService* appcache_service,
+    content::ResourceType resource_type,
+    std::vector<std::unique_ptr<content::ResourceThrottle>>* throttles) {
+  // Blink fetches <link rel=prefetch> itself but only the page, the
+  // prefetcher also warms the scripts and style sheets it references. Its
+  // own fetch of the page is served by the cache entry Blink is writing.
+  if (resource_type != content::RESOURCE_TYPE_PREFETCH)
+    return;
+
+  const content::ResourceRequestInfo* info =
+      content::ResourceRequestInfo::ForRequest(request);
+  if (!info)
+    return;
+
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                          base::Bind(&PrefetchInUI,
+                                     info->GetChildID(),
+                                     request->url(),
+                                     GURL(request->referrer())));
+}
+
 }  // namespace atom
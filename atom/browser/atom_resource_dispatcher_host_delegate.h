@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_ATOM_RESOURCE_DISPATCHER_HOST_DELEGATE_H_
 
 #include <memory>
+#include <vector>
 
 #include "content/public/browser/resource_dispatcher_host_delegate.h"
 
@@ -25,6 +26,13 @@ class AtomResourceDispatcherHostDelegate
       net::URLRequest* request) override;
   std::unique_ptr<net::ClientCertStore> CreateClientCertStore(
       content::ResourceContext* resource_context) override;
+  void RequestBeginning(
+      net::URLRequest* request,
+      content::ResourceContext* resource_context,
+      content::AppCacheService* appcache_service,
+      content::ResourceType resource_type,
+      std::vector<std::unique_ptr<content::ResourceThrottle>>* throttles)
+      override;
 };
 
 }  // namespace atom
@@ -4,6 +4,8 @@
 
 #include "atom/browser/browser_context_keyed_service_factories.h"
 
+#include "brave/browser/net/no_state_prefetcher_factory.h"
+#include "brave/browser/net/preconnect_predictor_factory.h"
 #include "chrome/browser/content_settings/cookie_settings_factory.h"
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/custom_handlers/protocol_handler_registry_factory.h"
@@ -85,6 +87,8 @@ void EnsureBrowserContextKeyedServiceFactoriesBuilt() {
   ProtocolHandlerRegistryFactory::GetInstance();
   HistoryServiceFactory::GetInstance();
   PasswordStoreFactory::GetInstance();
+  brave::NoStatePrefetcherFactory::GetInstance();
+  brave::PreconnectPredictorFactory::GetInstance();
 #if BUILDFLAG(ENABLE_SPELLCHECK)
   SpellcheckServiceFactory::GetInstance();
 #endif
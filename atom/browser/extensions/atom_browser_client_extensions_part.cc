@@ -6,9 +6,14 @@
 
 #include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "atom/common/api/api_messages.h"
 #include "base/command_line.h"
+#include "base/memory/ptr_util.h"
+#include "base/supports_user_data.h"
+#include "base/values.h"
 #include "brave/browser/api/brave_api_extension.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/profiles/profile.h"
@@ -91,6 +96,16 @@ RenderProcessHostPrivilege GetProcessPrivilege(
 
 static std::map<int, void*> render_process_hosts_;
 
+const char kContentSettingsSnapshotKey[] = "content_settings_snapshot";
+
+// The content settings the renderers of a browser context were last sent.
+struct ContentSettingsSnapshot : public base::SupportsUserData::Data {
+  explicit ContentSettingsSnapshot(const base::DictionaryValue& settings)
+      : settings(settings.CreateDeepCopy()) {}
+
+  std::unique_ptr<base::DictionaryValue> settings;
+};
+
 }  // namespace
 
 AtomBrowserClientExtensionsPart::AtomBrowserClientExtensionsPart() {
@@ -328,10 +343,15 @@ void AtomBrowserClientExtensionsPart::RenderProcessWillLaunch(
 
   auto user_prefs_registrar = context->user_prefs_change_registrar();
   if (!user_prefs_registrar->IsObserved("content_settings")) {
+    context->SetUserData(
+        kContentSettingsSnapshotKey,
+        base::MakeUnique<ContentSettingsSnapshot>(
+            *user_prefs::UserPrefs::Get(context)->GetDictionary(
+                "content_settings")));
     user_prefs_registrar->Add(
         "content_settings",
         base::Bind(&AtomBrowserClientExtensionsPart::UpdateContentSettings,
-                   base::Unretained(this)));
+                   base::Unretained(this), context));
   }
   UpdateContentSettingsForHost(host->GetID());
 }
@@ -375,12 +395,48 @@ void AtomBrowserClientExtensionsPart::UpdateContentSettingsForHost(
   host->Send(new AtomMsg_UpdateContentSettings(*content_settings));
 }
 
-void AtomBrowserClientExtensionsPart::UpdateContentSettings() {
+void AtomBrowserClientExtensionsPart::UpdateContentSettings(
+    BrowserContext* context) {
+  auto snapshot = static_cast<ContentSettingsSnapshot*>(
+      context->GetUserData(kContentSettingsSnapshotKey));
+  if (!snapshot)
+    return;
+
+  // Only send the content types that changed since the last update, the
+  // renderers already have the others.
+  const base::DictionaryValue* content_settings =
+    user_prefs::UserPrefs::Get(context)->GetDictionary("content_settings");
+  base::DictionaryValue changed_types;
+  std::vector<std::string> removed_types;
+  for (base::DictionaryValue::Iterator it(*content_settings);
+       !it.IsAtEnd(); it.Advance()) {
+    const base::Value* old_value = nullptr;
+    if (!snapshot->settings->GetWithoutPathExpansion(it.key(), &old_value) ||
+        !old_value->Equals(&it.value())) {
+      changed_types.SetWithoutPathExpansion(it.key(),
+                                            it.value().CreateDeepCopy());
+    }
+  }
+  for (base::DictionaryValue::Iterator it(*snapshot->settings);
+       !it.IsAtEnd(); it.Advance()) {
+    if (!content_settings->HasKey(it.key()))
+      removed_types.push_back(it.key());
+  }
+  snapshot->settings = content_settings->CreateDeepCopy();
+
+  if (changed_types.empty() && removed_types.empty())
+    return;
+
   for (std::map<int, void*>::iterator
       it = render_process_hosts_.begin();
       it != render_process_hosts_.end();
       ++it) {
-    UpdateContentSettingsForHost(it->first);
+    auto host = content::RenderProcessHost::FromID(it->first);
+    if (!host || host->GetBrowserContext() != context)
+      continue;
+
+    host->Send(new AtomMsg_UpdateContentSettingsDelta(changed_types,
+                                                      removed_types));
   }
 }
 
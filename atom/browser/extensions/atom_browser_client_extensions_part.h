@@ -86,7 +86,7 @@ class AtomBrowserClientExtensionsPart {
   std::string GetApplicationLocale();
 
  private:
-  void UpdateContentSettings();
+  void UpdateContentSettings(content::BrowserContext* context);
   void UpdateContentSettingsForHost(int render_process_id);
 
 
@@ -0,0 +1,163 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/ipc_stats.h"
+
+#include <algorithm>
+
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<IPCStats>::Leaky g_ipc_stats = LAZY_INSTANCE_INITIALIZER;
+
+// Channels can be made up per request, the stats of the ones past this many
+// are counted under kOtherChannels.
+const size_t kMaxChannels = 256;
+const char kOtherChannels[] = "(other)";
+
+const char* DirectionToString(IPCStats::Direction direction) {
+  switch (direction) {
+    case IPCStats::RENDERER_TO_BROWSER:
+      return "renderer-to-browser";
+    case IPCStats::RENDERER_TO_BROWSER_SYNC:
+      return "renderer-to-browser-sync";
+    case IPCStats::BROWSER_TO_RENDERER:
+      return "browser-to-renderer";
+  }
+  NOTREACHED();
+  return "";
+}
+
+}  // namespace
+
+IPCStats::Recorder::Recorder(Direction direction, size_t bytes)
+    : direction_(direction),
+      bytes_(bytes) {
+  if (IPCStats::GetInstance()->is_recording())
+    start_ = base::TimeTicks::Now();
+}
+
+IPCStats::Recorder::~Recorder() {
+  if (is_recording()) {
+    IPCStats::GetInstance()->Record(direction_, channel_, bytes_,
+                                    base::TimeTicks::Now() - start_);
+  }
+}
+
+IPCStats::ChannelStats::ChannelStats() : count(0), bytes(0) {
+}
+
+// static
+IPCStats* IPCStats::GetInstance() {
+  return g_ipc_stats.Pointer();
+}
+
+IPCStats::IPCStats() : recording_(false) {
+}
+
+IPCStats::~IPCStats() {
+}
+
+void IPCStats::Start() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  recording_ = true;
+}
+
+void IPCStats::Stop() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  recording_ = false;
+  pending_syncs_.clear();
+}
+
+void IPCStats::Record(Direction direction,
+                      const std::string& channel,
+                      size_t bytes,
+                      base::TimeDelta handling_time) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!recording_)
+    return;
+
+  ChannelStats& stats = GetChannelStats(direction, channel);
+  stats.count++;
+  stats.bytes += bytes;
+  stats.total_time += handling_time;
+  stats.max_time = std::max(stats.max_time, handling_time);
+}
+
+void IPCStats::BeginSync(IPC::Message* reply, const std::string& channel) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  TRACE_EVENT_ASYNC_BEGIN1("ipc", "RendererBlockedOnSyncMessage", reply,
+                           "channel", channel);
+  if (!recording_)
+    return;
+
+  PendingSync& pending = pending_syncs_[reply];
+  pending.channel = channel;
+  pending.start = base::TimeTicks::Now();
+}
+
+void IPCStats::EndSync(IPC::Message* reply, bool sent) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  TRACE_EVENT_ASYNC_END1("ipc", "RendererBlockedOnSyncMessage", reply,
+                         "sent", sent);
+  auto it = pending_syncs_.find(reply);
+  if (it == pending_syncs_.end())
+    return;
+
+  base::TimeDelta blocked_time = base::TimeTicks::Now() - it->second.start;
+  ChannelStats& stats =
+      GetChannelStats(RENDERER_TO_BROWSER_SYNC, it->second.channel);
+  stats.total_blocked_time += blocked_time;
+  stats.max_blocked_time = std::max(stats.max_blocked_time, blocked_time);
+  pending_syncs_.erase(it);
+}
+
+std::unique_ptr<base::ListValue> IPCStats::GetStats() const {
+  std::unique_ptr<base::ListValue> list(new base::ListValue);
+  for (const auto& it : stats_) {
+    const ChannelStats& stats = it.second;
+    std::unique_ptr<base::DictionaryValue> entry(new base::DictionaryValue);
+    entry->SetString("direction", DirectionToString(it.first.first));
+    entry->SetString("channel", it.first.second);
+    entry->SetDouble("count", stats.count);
+    entry->SetDouble("bytes", stats.bytes);
+    entry->SetDouble("totalTime", stats.total_time.InMillisecondsF());
+    entry->SetDouble("maxTime", stats.max_time.InMillisecondsF());
+    if (it.first.first == RENDERER_TO_BROWSER_SYNC) {
+      entry->SetDouble("totalBlockedTime",
+                       stats.total_blocked_time.InMillisecondsF());
+      entry->SetDouble("maxBlockedTime",
+                       stats.max_blocked_time.InMillisecondsF());
+    }
+    list->Append(std::move(entry));
+  }
+  return list;
+}
+
+void IPCStats::Reset() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  stats_.clear();
+}
+
+IPCStats::ChannelStats& IPCStats::GetChannelStats(
+    Direction direction,
+    const std::string& channel) {
+  auto key = std::make_pair(direction, channel);
+  auto it = stats_.find(key);
+  if (it != stats_.end())
+    return it->second;
+
+  if (stats_.size() >= kMaxChannels)
+    key.second = kOtherChannels;
+  return stats_[key];
+}
+
+}  // namespace atom
@@ -0,0 +1,120 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_IPC_STATS_H_
+#define ATOM_BROWSER_IPC_STATS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+
+namespace base {
+class ListValue;
+}
+
+namespace IPC {
+class Message;
+}
+
+namespace atom {
+
+// Counts the IPC messages between renderers and the browser per channel and
+// direction, with their size and how long they took to handle. For
+// synchronous messages it also records how long the renderer was blocked,
+// from the message arriving to its reply being sent.
+//
+// Nothing is recorded until Start() is called. Past 256 distinct
+// channels, the messages of new channels are counted together.
+//
+// Lives on the UI thread.
+class IPCStats {
+ public:
+  enum Direction {
+    RENDERER_TO_BROWSER,
+    RENDERER_TO_BROWSER_SYNC,
+    BROWSER_TO_RENDERER,
+  };
+
+  // Times the handling or sending of a message until it goes out of scope,
+  // if the stats are being recorded.
+  class Recorder {
+   public:
+    Recorder(Direction direction, size_t bytes);
+    ~Recorder();
+
+    // The channel is only worth computing when recording.
+    bool is_recording() const { return !start_.is_null(); }
+    void set_channel(const std::string& channel) { channel_ = channel; }
+    void set_bytes(size_t bytes) { bytes_ = bytes; }
+
+   private:
+    Direction direction_;
+    std::string channel_;
+    size_t bytes_;
+    base::TimeTicks start_;
+
+    DISALLOW_COPY_AND_ASSIGN(Recorder);
+  };
+
+  static IPCStats* GetInstance();
+
+  void Start();
+  void Stop();
+  bool is_recording() const { return recording_; }
+
+  void Record(Direction direction,
+              const std::string& channel,
+              size_t bytes,
+              base::TimeDelta handling_time);
+
+  // Traces that the renderer waits for |reply| to a message on |channel|,
+  // and records how long if the stats are being recorded.
+  void BeginSync(IPC::Message* reply, const std::string& channel);
+  // The renderer stops waiting for |reply|, whether it was sent or not.
+  void EndSync(IPC::Message* reply, bool sent);
+
+  // Returns one entry per channel and direction.
+  std::unique_ptr<base::ListValue> GetStats() const;
+  void Reset();
+
+ private:
+  struct ChannelStats {
+    ChannelStats();
+
+    uint64_t count;
+    uint64_t bytes;
+    base::TimeDelta total_time;
+    base::TimeDelta max_time;
+    base::TimeDelta total_blocked_time;
+    base::TimeDelta max_blocked_time;
+  };
+
+  struct PendingSync {
+    std::string channel;
+    base::TimeTicks start;
+  };
+
+  friend struct base::LazyInstanceTraitsBase<IPCStats>;
+
+  IPCStats();
+  ~IPCStats();
+
+  ChannelStats& GetChannelStats(Direction direction,
+                                const std::string& channel);
+
+  bool recording_;
+  std::map<std::pair<Direction, std::string>, ChannelStats> stats_;
+  std::map<IPC::Message*, PendingSync> pending_syncs_;
+
+  DISALLOW_COPY_AND_ASSIGN(IPCStats);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_IPC_STATS_H_
@@ -193,6 +193,12 @@ void JavascriptEnvironment::OnMessageLoopDestroying() {
 bool JavascriptEnvironment::Initialize() {
   auto cmd = base::CommandLine::ForCurrentProcess();
 
+  // SharedArrayBuffers can be posted between the main process and workers,
+  // --js-flags can still turn them off.
+  const char kSharedArrayBufferFlag[] = "--harmony-sharedarraybuffer";
+  v8::V8::SetFlagsFromString(kSharedArrayBufferFlag,
+                             sizeof(kSharedArrayBufferFlag) - 1);
+
   // --js-flags.
   std::string js_flags = cmd->GetSwitchValueASCII(switches::kJavaScriptFlags);
   if (!js_flags.empty())
@@ -0,0 +1,130 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/atom_cookie_delegate.h"
+
+#include <list>
+#include <string>
+#include <tuple>
+
+#include "base/bind.h"
+#include "base/timer/timer.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+class AtomCookieDelegate::Subscription {
+ public:
+  Subscription(const ChangeFilter& filter,
+               base::TimeDelta interval,
+               const ChangesCallback& callback)
+      : filter_(filter),
+        interval_(interval),
+        callback_(callback) {
+  }
+
+  void OnCookieChanged(const Change& change) {
+    if (!filter_.is_null() && !filter_.Run(change.cookie))
+      return;
+
+    // A batch holds at most the first removal of a cookie, the one its
+    // listeners know about, and its last addition. An overwrite is thus
+    // still delivered as `overwritten` followed by `added`, while a cookie
+    // added and removed within the batch is not delivered at all.
+    Key key(change.cookie.Name(), change.cookie.Domain(),
+            change.cookie.Path());
+    Pending& pending = pending_by_key_.emplace(
+        key, Pending{pending_.end(), pending_.end()}).first->second;
+    bool was_added = pending.added != pending_.end();
+    if (was_added) {
+      pending_.erase(pending.added);
+      pending.added = pending_.end();
+    }
+    if (!change.removed)
+      pending.added = pending_.insert(pending_.end(), change);
+    else if (pending.removed != pending_.end())
+      pending.removed->cause = change.cause;
+    else if (!was_added)
+      pending.removed = pending_.insert(pending_.end(), change);
+
+    if (!timer_.IsRunning()) {
+      timer_.Start(FROM_HERE, interval_,
+                   base::Bind(&Subscription::Flush, base::Unretained(this)));
+    }
+  }
+
+ private:
+  using Key = std::tuple<std::string, std::string, std::string>;
+
+  // The pending changes of a cookie, end() when there are none.
+  struct Pending {
+    std::list<Change>::iterator removed;
+    std::list<Change>::iterator added;
+  };
+
+  void Flush() {
+    std::vector<Change> changes(pending_.begin(), pending_.end());
+    pending_.clear();
+    pending_by_key_.clear();
+    callback_.Run(changes);
+  }
+
+  ChangeFilter filter_;
+  base::TimeDelta interval_;
+  ChangesCallback callback_;
+
+  std::list<Change> pending_;
+  std::map<Key, Pending> pending_by_key_;
+  base::OneShotTimer timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(Subscription);
+};
+
+AtomCookieDelegate::Change::Change(const net::CanonicalCookie& cookie,
+                                   bool removed,
+                                   net::CookieStore::ChangeCause cause)
+    : cookie(cookie),
+      removed(removed),
+      cause(cause) {
+}
+
+AtomCookieDelegate::AtomCookieDelegate() {
+}
+
+AtomCookieDelegate::~AtomCookieDelegate() {
+  // The subscription timers belong to the IO thread.
+  for (auto& it : subscriptions_)
+    BrowserThread::DeleteSoon(BrowserThread::IO, FROM_HERE,
+                              it.second.release());
+}
+
+void AtomCookieDelegate::AddSubscription(int id,
+                                         const ChangeFilter& filter,
+                                         base::TimeDelta interval,
+                                         const ChangesCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  subscriptions_[id].reset(new Subscription(filter, interval, callback));
+}
+
+void AtomCookieDelegate::RemoveSubscription(int id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  subscriptions_.erase(id);
+}
+
+void AtomCookieDelegate::OnCookieChanged(
+    const net::CanonicalCookie& cookie,
+    bool removed,
+    net::CookieStore::ChangeCause cause) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (subscriptions_.empty())
+    return;
+
+  Change change(cookie, removed, cause);
+  for (const auto& it : subscriptions_)
+    it.second->OnCookieChanged(change);
+}
+
+}  // namespace atom
@@ -0,0 +1,69 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_ATOM_COOKIE_DELEGATE_H_
+#define ATOM_BROWSER_NET_ATOM_COOKIE_DELEGATE_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_monster.h"
+#include "net/cookies/cookie_store.h"
+
+namespace atom {
+
+// Receives the changes of a cookie store and hands them to subscribers in
+// batches, at most once per subscription interval.
+//
+// Subscriptions are added, removed and notified on the IO thread.
+class AtomCookieDelegate : public net::CookieMonsterDelegate {
+ public:
+  struct Change {
+    Change(const net::CanonicalCookie& cookie,
+           bool removed,
+           net::CookieStore::ChangeCause cause);
+
+    net::CanonicalCookie cookie;
+    bool removed;
+    net::CookieStore::ChangeCause cause;
+  };
+
+  using ChangeFilter = base::Callback<bool(const net::CanonicalCookie&)>;
+  using ChangesCallback = base::Callback<void(const std::vector<Change>&)>;
+
+  AtomCookieDelegate();
+
+  // Calls |callback| with the changes to the cookies matching |filter|,
+  // every |interval| as long as there are any. The changes of a cookie
+  // within a batch are collapsed into its first removal, if any, followed by
+  // its last addition.
+  void AddSubscription(int id,
+                       const ChangeFilter& filter,
+                       base::TimeDelta interval,
+                       const ChangesCallback& callback);
+  void RemoveSubscription(int id);
+
+  // net::CookieMonsterDelegate:
+  void OnCookieChanged(const net::CanonicalCookie& cookie,
+                       bool removed,
+                       net::CookieStore::ChangeCause cause) override;
+
+ private:
+  class Subscription;
+
+  ~AtomCookieDelegate() override;
+
+  std::map<int, std::unique_ptr<Subscription>> subscriptions_;
+
+  DISALLOW_COPY_AND_ASSIGN(AtomCookieDelegate);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_ATOM_COOKIE_DELEGATE_H_
@@ -4,6 +4,12 @@
 
 // Multiply-included file, no traditional include guard.
 
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
 #include "base/strings/string16.h"
 #include "base/memory/shared_memory.h"
 #include "base/values.h"
@@ -16,20 +22,71 @@
 
 #define IPC_MESSAGE_START ShellMsgStart
 
+// The number of times a renderer received each remote object, by id.
+using AtomRemoteObjectCounts = std::map<int32_t, int32_t>;
+
 IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+// Forwarded by the browser as an AtomViewMsg_Message to the WebContents with
+// |web_contents_id|.
+IPC_MESSAGE_ROUTED4(AtomViewHostMsg_Message_SendTo,
+                    bool /* send_to_all */,
+                    int32_t /* web_contents_id */,
+                    base::string16 /* channel */,
+                    base::ListValue /* arguments */)
+
+// Releases the remote objects the renderer no longer references, with the
+// number of times it received each of them.
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_Dereference,
+                    AtomRemoteObjectCounts /* counts */)
+
 IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync,
                            base::string16 /* channel */,
                            base::ListValue /* arguments */,
-                           base::string16 /* result (in JSON) */)
+                           std::vector<uint8_t> /* result (structured clone) */)
 
 IPC_MESSAGE_ROUTED3(AtomViewMsg_Message,
                     bool /* send_to_all */,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+// Like AtomViewHostMsg_Message/AtomViewMsg_Message, with the arguments
+// serialized by v8::ValueSerializer.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Structured,
+                    base::string16 /* channel */,
+                    std::vector<uint8_t> /* arguments */)
+
+IPC_MESSAGE_ROUTED3(AtomViewMsg_Message_Structured,
+                    bool /* send_to_all */,
+                    base::string16 /* channel */,
+                    std::vector<uint8_t> /* arguments */)
+
+// Like the above, with arguments larger than
+// kStructuredCloneSharedMemoryThreshold passed in shared memory. Renderers
+// write them to memory allocated by AtomViewHostMsg_AllocateStructuredShared,
+// so that the browser only maps memory it knows the size of. Allocations over
+// kMaxStructuredCloneSize are refused with an id of 0.
+IPC_SYNC_MESSAGE_ROUTED1_2(AtomViewHostMsg_AllocateStructuredShared,
+                           uint32_t /* size */,
+                           int32_t /* id */,
+                           base::SharedMemoryHandle /* memory */)
+
+IPC_MESSAGE_ROUTED3(AtomViewHostMsg_Message_Structured_Shared,
+                    base::string16 /* channel */,
+                    int32_t /* id of the memory */,
+                    uint32_t /* size */)
+
+// Every context of the view receives the message, |id| lets them share the
+// memory mapped by the first one, as the handle can only be taken once.
+IPC_MESSAGE_ROUTED5(AtomViewMsg_Message_Structured_Shared,
+                    bool /* send_to_all */,
+                    base::string16 /* channel */,
+                    int32_t /* id */,
+                    base::SharedMemoryHandle /* arguments */,
+                    uint32_t /* size */)
+
 IPC_MESSAGE_ROUTED2(AtomViewMsg_Message_Shared,
                     base::string16 /* channel */,
                     base::SharedMemoryHandle /* arguments */)
@@ -40,5 +97,10 @@ IPC_MESSAGE_CONTROL1(AtomMsg_UpdatePreferences, base::ListValue)
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateContentSettings, base::DictionaryValue)
 
+// Update the rules of some content types in the renderer content settings
+IPC_MESSAGE_CONTROL2(AtomMsg_UpdateContentSettingsDelta,
+                     base::DictionaryValue /* changed content types */,
+                     std::vector<std::string> /* removed content types */)
+
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateWebKitPrefs, content::WebPreferences)
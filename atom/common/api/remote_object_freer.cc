@@ -4,10 +4,16 @@
 
 #include "atom/common/api/remote_object_freer.h"
 
+#include <map>
+
 #include "atom/common/api/api_messages.h"
-#include "base/strings/utf_string_conversions.h"
-#include "base/values.h"
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/location.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
 #include "content/public/renderer/render_view.h"
+#include "native_mate/converter.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
 #include "third_party/WebKit/public/web/WebView.h"
 
@@ -18,6 +24,29 @@ namespace atom {
 
 namespace {
 
+// Released objects are reported to the browser in batches, at most this often.
+const int kDereferenceDelayMs = 100;
+
+// The released objects not reported yet, by routing id.
+base::LazyInstance<std::map<int, AtomRemoteObjectCounts>>::Leaky
+    g_pending_dereferences = LAZY_INSTANCE_INITIALIZER;
+
+v8::Local<v8::Private> GetFreerKey(v8::Isolate* isolate) {
+  return v8::Private::ForApi(
+      isolate, mate::StringToV8(isolate, "electron:remoteObjectFreer"));
+}
+
+void SendPendingDereferences() {
+  std::map<int, AtomRemoteObjectCounts> pending;
+  pending.swap(g_pending_dereferences.Get());
+  for (const auto& it : pending) {
+    content::RenderView* render_view =
+        content::RenderView::FromRoutingID(it.first);
+    if (render_view)
+      render_view->Send(new AtomViewHostMsg_Dereference(it.first, it.second));
+  }
+}
+
 content::RenderView* GetCurrentRenderView() {
   WebLocalFrame* frame = WebLocalFrame::FrameForCurrentContext();
   if (!frame)
@@ -35,13 +64,28 @@ content::RenderView* GetCurrentRenderView() {
 // static
 void RemoteObjectFreer::BindTo(
     v8::Isolate* isolate, v8::Local<v8::Object> target, int object_id) {
-  new RemoteObjectFreer(isolate, target, object_id);
+  // The object was received again, it is released that many times more.
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Value> freer;
+  if (target->GetPrivate(context, GetFreerKey(isolate)).ToLocal(&freer) &&
+      freer->IsExternal()) {
+    auto self = static_cast<RemoteObjectFreer*>(
+        v8::Local<v8::External>::Cast(freer)->Value());
+    DCHECK_EQ(self->object_id_, object_id);
+    self->ref_count_++;
+    return;
+  }
+
+  auto self = new RemoteObjectFreer(isolate, target, object_id);
+  target->SetPrivate(context, GetFreerKey(isolate),
+                     v8::External::New(isolate, self));
 }
 
 RemoteObjectFreer::RemoteObjectFreer(
     v8::Isolate* isolate, v8::Local<v8::Object> target, int object_id)
     : ObjectLifeMonitor(isolate, target),
       object_id_(object_id),
+      ref_count_(1),
       routing_id_(MSG_ROUTING_NONE) {
   content::RenderView* render_view = GetCurrentRenderView();
   if (render_view) {
@@ -53,17 +97,17 @@ RemoteObjectFreer::~RemoteObjectFreer() {
 }
 
 void RemoteObjectFreer::RunDestructor() {
-  content::RenderView* render_view =
-      content::RenderView::FromRoutingID(routing_id_);
-  if (!render_view)
+  if (routing_id_ == MSG_ROUTING_NONE)
     return;
 
-  base::string16 channel = base::ASCIIToUTF16("ipc-message");
-  base::ListValue args;
-  args.AppendString("ELECTRON_BROWSER_DEREFERENCE");
-  args.AppendInteger(object_id_);
-  render_view->Send(
-      new AtomViewHostMsg_Message(render_view->GetRoutingID(), channel, args));
+  std::map<int, AtomRemoteObjectCounts>& pending =
+      g_pending_dereferences.Get();
+  if (pending.empty()) {
+    base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE, base::Bind(&SendPendingDereferences),
+        base::TimeDelta::FromMilliseconds(kDereferenceDelayMs));
+  }
+  pending[routing_id_][object_id_] += ref_count_;
 }
 
 }  // namespace atom
@@ -11,6 +11,7 @@ namespace atom {
 
 class RemoteObjectFreer : public ObjectLifeMonitor {
  public:
+  // Binding an object again counts one more time it was received.
   static void BindTo(
       v8::Isolate* isolate, v8::Local<v8::Object> target, int object_id);
 
@@ -23,6 +24,8 @@ class RemoteObjectFreer : public ObjectLifeMonitor {
 
  private:
   int object_id_;
+  // The number of times the browser sent the object.
+  int ref_count_;
   int routing_id_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteObjectFreer);
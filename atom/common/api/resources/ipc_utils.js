@@ -6,16 +6,39 @@ var ipcRenderer = atom.v8.getHiddenValue('ipc')
 if (!ipcRenderer) {
   ipcRenderer = new EventEmitter
 
+  // Run before every message to the browser, so that messages queued by
+  // other modules, like the property writes of remote, are sent first.
+  var beforeSendHooks = []
+
+  var runBeforeSendHooks = function () {
+    for (var i = 0; i < beforeSendHooks.length; i++) {
+      beforeSendHooks[i]()
+    }
+  }
+
+  ipcRenderer.addBeforeSendHook = function (hook) {
+    beforeSendHooks.push(hook)
+  }
+
   ipcRenderer.send = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
+    runBeforeSendHooks()
     return ipc.send('ipc-message', $Array.slice(args))
   }
 
   ipcRenderer.sendSync = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
-    return $JSON.parse(ipc.sendSync('ipc-message-sync', $Array.slice(args)))
+    runBeforeSendHooks()
+    return ipc.sendSync('ipc-message-sync', $Array.slice(args))
+  }
+
+  ipcRenderer.sendStructured = function () {
+    var args
+    args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
+    runBeforeSendHooks()
+    return ipc.sendStructured('ipc-message', args)
   }
 
   ipcRenderer.sendToHost = function () {
@@ -24,6 +47,22 @@ if (!ipcRenderer) {
     return ipc.send('ipc-message-host', $Array.slice(args))
   }
 
+  ipcRenderer.sendTo = function (webContentsId, channel) {
+    if (typeof webContentsId !== 'number') {
+      throw new TypeError('First argument has to be webContentsId')
+    }
+    var args = $Array.slice(arguments, 2)
+    return ipc.sendTo(false, webContentsId, channel, args)
+  }
+
+  ipcRenderer.sendToAll = function (webContentsId, channel) {
+    if (typeof webContentsId !== 'number') {
+      throw new TypeError('First argument has to be webContentsId')
+    }
+    var args = $Array.slice(arguments, 2)
+    return ipc.sendTo(true, webContentsId, channel, args)
+  }
+
   ipcRenderer.emit = function () {
     if (arguments[1]) {
       arguments[1].sender = ipcRenderer
@@ -44,6 +83,7 @@ function guid() {
 }
 
 exports.$set('guid', guid)
+exports.$set('addBeforeSendHook', ipcRenderer.addBeforeSendHook.bind(ipcRenderer))
 exports.$set('removeListener', ipcRenderer.removeListener.bind(ipcRenderer))
 exports.$set('off', ipcRenderer.off.bind(ipcRenderer))
 exports.$set('removeAllListeners', ipcRenderer.removeAllListeners.bind(ipcRenderer))
@@ -51,6 +91,9 @@ exports.$set('on', ipcRenderer.on.bind(ipcRenderer))
 exports.$set('once', ipcRenderer.once.bind(ipcRenderer))
 exports.$set('send', ipcRenderer.send.bind(ipcRenderer))
 exports.$set('sendSync', ipcRenderer.sendSync.bind(ipcRenderer))
+exports.$set('sendStructured', ipcRenderer.sendStructured.bind(ipcRenderer))
 exports.$set('sendToHost', ipcRenderer.sendToHost.bind(ipcRenderer))
+exports.$set('sendTo', ipcRenderer.sendTo.bind(ipcRenderer))
+exports.$set('sendToAll', ipcRenderer.sendToAll.bind(ipcRenderer))
 exports.$set('emit', ipcRenderer.emit.bind(ipcRenderer))
 
@@ -0,0 +1,90 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/structured_clone.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <utility>
+
+namespace atom {
+
+namespace {
+
+v8::MaybeLocal<v8::Value> Deserialize(v8::Isolate* isolate,
+                                      const uint8_t* data,
+                                      size_t size) {
+  if (size == 0)
+    return v8::MaybeLocal<v8::Value>();
+
+  v8::EscapableHandleScope handle_scope(isolate);
+  v8::TryCatch try_catch(isolate);
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::ValueDeserializer deserializer(isolate, data, size);
+  bool read = false;
+  v8::Local<v8::Value> value;
+  if (!deserializer.ReadHeader(context).To(&read) || !read ||
+      !deserializer.ReadValue(context).ToLocal(&value)) {
+    return v8::MaybeLocal<v8::Value>();
+  }
+  return handle_scope.Escape(value);
+}
+
+}  // namespace
+
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      std::vector<uint8_t>* data) {
+  v8::ValueSerializer serializer(isolate);
+  serializer.WriteHeader();
+
+  bool wrote = false;
+  if (!serializer.WriteValue(isolate->GetCurrentContext(), value).To(&wrote) ||
+      !wrote) {
+    return false;
+  }
+
+  std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  data->assign(buffer.first, buffer.first + buffer.second);
+  free(buffer.first);
+  return true;
+}
+
+v8::MaybeLocal<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate,
+    const std::vector<uint8_t>& data) {
+  return Deserialize(isolate, data.data(), data.size());
+}
+
+v8::MaybeLocal<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate,
+    base::SharedMemory* shared_memory,
+    size_t size) {
+  if (!shared_memory->memory() && !shared_memory->Map(size))
+    return v8::MaybeLocal<v8::Value>();
+  if (size > shared_memory->mapped_size())
+    return v8::MaybeLocal<v8::Value>();
+
+  // Copied first, so that the bytes can't change while they are parsed.
+  const uint8_t* memory =
+      static_cast<const uint8_t*>(shared_memory->memory());
+  std::vector<uint8_t> data(memory, memory + size);
+  return Deserialize(isolate, data.data(), data.size());
+}
+
+bool CopyToSharedMemory(const std::vector<uint8_t>& data,
+                        base::SharedMemory* shared_memory,
+                        base::SharedMemoryHandle* handle) {
+  if (!shared_memory->memory() && !shared_memory->Map(data.size()))
+    return false;
+
+  memcpy(shared_memory->memory(), data.data(), data.size());
+  shared_memory->Unmap();
+
+  *handle = shared_memory->handle().Duplicate();
+  return handle->IsValid();
+}
+
+}  // namespace atom
@@ -0,0 +1,53 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_STRUCTURED_CLONE_H_
+#define ATOM_COMMON_API_STRUCTURED_CLONE_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/memory/shared_memory.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// Structured clones at least this large are passed in shared memory rather
+// than inline in the IPC message, so they aren't copied through the channel.
+const size_t kStructuredCloneSharedMemoryThreshold = 128 * 1024;
+
+// The largest structured clone that can be passed in shared memory, the same
+// as the largest IPC message.
+const size_t kMaxStructuredCloneSize = 128 * 1024 * 1024;
+
+// Serializes |value| with the structured clone algorithm, which keeps Dates,
+// Maps, Sets, ArrayBuffers and typed arrays intact. Returns false, with a
+// DataCloneError thrown in |isolate|, if |value| can't be cloned.
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      std::vector<uint8_t>* data);
+
+// Returns an empty handle, without throwing, if |data| isn't a valid
+// serialized value.
+v8::MaybeLocal<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
+                                             const std::vector<uint8_t>& data);
+
+// Like above, reading a copy of the first |size| bytes of |shared_memory|,
+// since the other process may still have it mapped writable. Maps
+// |shared_memory| if it isn't yet, and fails if it is smaller.
+v8::MaybeLocal<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate,
+    base::SharedMemory* shared_memory,
+    size_t size);
+
+// Copies |data| to |shared_memory|, which must be at least as large, and
+// returns a handle to pass to the other process in |handle|.
+bool CopyToSharedMemory(const std::vector<uint8_t>& data,
+                        base::SharedMemory* shared_memory,
+                        base::SharedMemoryHandle* handle);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_STRUCTURED_CLONE_H_
@@ -4,14 +4,21 @@
 
 #include "atom/common/javascript_bindings.h"
 
+#include <string.h>
+
+#include <map>
+#include <utility>
 #include <vector>
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_api_key_weak_map.h"
 #include "atom/common/api/remote_callback_freer.h"
 #include "atom/common/api/remote_object_freer.h"
+#include "atom/common/api/structured_clone.h"
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/lazy_instance.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_view.h"
@@ -34,6 +41,30 @@ std::vector<v8::Local<v8::Value>> ListValueToVector(v8::Isolate* isolate,
   return result;
 }
 
+// The memory of the AtomViewMsg_Message_Structured_Shared being dispatched
+// to the contexts of a view, by message id.
+base::LazyInstance<std::map<int32_t, std::unique_ptr<base::SharedMemory>>>::
+    Leaky g_structured_shared_memory = LAZY_INSTANCE_INITIALIZER;
+
+void ReleaseStructuredSharedMemory(int32_t id) {
+  g_structured_shared_memory.Get().erase(id);
+}
+
+// Takes the memory from |handle| for the first context that receives message
+// |id|, the others get it from here until the message has been dispatched.
+base::SharedMemory* GetStructuredSharedMemory(
+    int32_t id,
+    const base::SharedMemoryHandle& handle) {
+  std::unique_ptr<base::SharedMemory>& shared_memory =
+      g_structured_shared_memory.Get()[id];
+  if (!shared_memory) {
+    shared_memory.reset(new base::SharedMemory(handle, true));
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&ReleaseStructuredSharedMemory, id));
+  }
+  return shared_memory.get();
+}
+
 }  // namespace
 
 JavascriptBindings::JavascriptBindings(content::RenderView* render_view,
@@ -138,23 +169,98 @@ void JavascriptBindings::IPCSend(mate::Arguments* args,
     args->ThrowError("Unable to send AtomViewHostMsg_Message");
 }
 
-base::string16 JavascriptBindings::IPCSendSync(mate::Arguments* args,
+void JavascriptBindings::IPCSendTo(mate::Arguments* args,
+          bool send_to_all,
+          int32_t web_contents_id,
+          const base::string16& channel,
+          const base::ListValue& arguments) {
+  if (!is_valid() || !render_view())
+    return;
+
+  bool success = render_view()->Send(new AtomViewHostMsg_Message_SendTo(
+      render_view()->GetRoutingID(), send_to_all, web_contents_id, channel,
+      arguments));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_Message_SendTo");
+}
+
+void JavascriptBindings::IPCSendStructured(mate::Arguments* args,
+          const base::string16& channel,
+          v8::Local<v8::Value> arguments) {
+  if (!is_valid() || !render_view())
+    return;
+
+  // A DataCloneError has been thrown if the arguments can't be serialized.
+  std::vector<uint8_t> data;
+  if (!SerializeV8Value(args->isolate(), arguments, &data))
+    return;
+
+  if (data.size() < kStructuredCloneSharedMemoryThreshold) {
+    bool success = render_view()->Send(new AtomViewHostMsg_Message_Structured(
+        render_view()->GetRoutingID(), channel, data));
+
+    if (!success)
+      args->ThrowError("Unable to send AtomViewHostMsg_Message_Structured");
+    return;
+  }
+
+  if (data.size() > kMaxStructuredCloneSize) {
+    args->ThrowError("The arguments are too large to be sent");
+    return;
+  }
+
+  // Renderers can't create shared memory themselves in the sandbox, the
+  // browser allocates it and only trusts the size it allocated.
+  int32_t id = 0;
+  base::SharedMemoryHandle handle;
+  bool success = render_view()->Send(
+      new AtomViewHostMsg_AllocateStructuredShared(
+          render_view()->GetRoutingID(), data.size(), &id, &handle)) && id;
+  if (success) {
+    // The memory is released by the message, even if it can't be written.
+    base::SharedMemory shared_memory(handle, false);
+    uint32_t size = 0;
+    if (shared_memory.Map(data.size())) {
+      memcpy(shared_memory.memory(), data.data(), data.size());
+      size = data.size();
+    }
+    success = render_view()->Send(
+        new AtomViewHostMsg_Message_Structured_Shared(
+            render_view()->GetRoutingID(), channel, id, size)) && size;
+  }
+
+  if (!success)
+    args->ThrowError(
+        "Unable to send AtomViewHostMsg_Message_Structured_Shared");
+}
+
+v8::Local<v8::Value> JavascriptBindings::IPCSendSync(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments) {
-  base::string16 json;
-
+  v8::Isolate* isolate = args->isolate();
   if (!is_valid() || !render_view()) {
-    return json;
+    return v8::Undefined(isolate);
   }
 
+  std::vector<uint8_t> result;
   IPC::SyncMessage* message = new AtomViewHostMsg_Message_Sync(
-      render_view()->GetRoutingID(), channel, arguments, &json);
+      render_view()->GetRoutingID(), channel, arguments, &result);
   bool success = render_view()->Send(message);
 
-  if (!success)
+  if (!success) {
     args->ThrowError("Unable to send AtomViewHostMsg_Message_Sync");
+    return v8::Undefined(isolate);
+  }
 
-  return json;
+  // The result is deserialized straight into the calling context, without
+  // going through JSON on either side.
+  v8::Local<v8::Value> value;
+  if (!DeserializeV8Value(isolate, result).ToLocal(&value)) {
+    args->ThrowError("Invalid AtomViewHostMsg_Message_Sync result");
+    return v8::Undefined(isolate);
+  }
+  return value;
 }
 
 void JavascriptBindings::GetBinding(
@@ -170,6 +276,11 @@ void JavascriptBindings::GetBinding(
       base::Unretained(this)));
   ipc.SetMethod("sendSync", base::Bind(&JavascriptBindings::IPCSendSync,
       base::Unretained(this)));
+  ipc.SetMethod("sendTo", base::Bind(&JavascriptBindings::IPCSendTo,
+      base::Unretained(this)));
+  ipc.SetMethod("sendStructured",
+      base::Bind(&JavascriptBindings::IPCSendStructured,
+      base::Unretained(this)));
   binding.Set("ipc", ipc.GetHandle());
 
   mate::Dictionary v8(isolate, v8::Object::New(isolate));
@@ -210,14 +321,21 @@ bool JavascriptBindings::OnMessageReceived(const IPC::Message& message) {
       context_type == Feature::BLESSED_EXTENSION_CONTEXT) {
     bool handled = true;
     IPC_BEGIN_MESSAGE_MAP(JavascriptBindings, message)
+      // The shared memory handle can only be taken from the message once.
       IPC_MESSAGE_HANDLER(AtomViewMsg_Message_Shared, OnSharedBrowserMessage)
       IPC_MESSAGE_UNHANDLED(handled = false)
     IPC_END_MESSAGE_MAP()
+    if (handled)
+      return true;
   }
 
   bool handled = false;  // don't swallow any of these messages
   IPC_BEGIN_MESSAGE_MAP(JavascriptBindings, message)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_Message_Structured,
+                        OnStructuredBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_Message_Structured_Shared,
+                        OnStructuredSharedBrowserMessage)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -237,20 +355,7 @@ void JavascriptBindings::OnSharedBrowserMessage(const base::string16& channel,
   args_vector.insert(args_vector.begin(),
       brave::SharedMemoryWrapper::CreateFrom(isolate, handle).ToV8());
 
-  // Insert the Event object, event.sender is ipc
-  mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
-  args_vector.insert(args_vector.begin(), event.GetHandle());
-
-  std::vector<v8::Local<v8::Value>> concatenated_args =
-        { mate::StringToV8(isolate, channel) };
-      concatenated_args.reserve(1 + args_vector.size());
-      concatenated_args.insert(concatenated_args.end(),
-                                args_vector.begin(), args_vector.end());
-
-  context()->module_system()->CallModuleMethod("ipc_utils",
-                                  "emit",
-                                  concatenated_args.size(),
-                                  &concatenated_args.front());
+  EmitBrowserMessage(channel, std::move(args_vector));
 }
 
 void JavascriptBindings::OnBrowserMessage(bool all_frames,
@@ -263,7 +368,60 @@ void JavascriptBindings::OnBrowserMessage(bool all_frames,
   v8::HandleScope handle_scope(isolate);
   v8::Context::Scope context_scope(context()->v8_context());
 
-  auto args_vector = ListValueToVector(isolate, args);
+  EmitBrowserMessage(channel, ListValueToVector(isolate, args));
+}
+
+void JavascriptBindings::OnStructuredBrowserMessage(
+    bool all_frames,
+    const base::string16& channel,
+    const std::vector<uint8_t>& args) {
+  if (!is_valid())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context()->v8_context());
+
+  EmitStructuredBrowserMessage(channel, DeserializeV8Value(isolate, args));
+}
+
+void JavascriptBindings::OnStructuredSharedBrowserMessage(
+    bool all_frames,
+    const base::string16& channel,
+    int32_t id,
+    const base::SharedMemoryHandle& handle,
+    uint32_t size) {
+  // Taken even if this context can't use it, for the other contexts.
+  base::SharedMemory* shared_memory = GetStructuredSharedMemory(id, handle);
+  if (!is_valid())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context()->v8_context());
+
+  EmitStructuredBrowserMessage(
+      channel, DeserializeV8Value(isolate, shared_memory, size));
+}
+
+void JavascriptBindings::EmitStructuredBrowserMessage(
+    const base::string16& channel,
+    v8::MaybeLocal<v8::Value> args) {
+  v8::Local<v8::Value> value;
+  std::vector<v8::Local<v8::Value>> args_vector;
+  if (!args.ToLocal(&value) ||
+      !mate::ConvertFromV8(context()->isolate(), value, &args_vector)) {
+    LOG(ERROR) << "Invalid AtomViewMsg_Message_Structured arguments";
+    return;
+  }
+
+  EmitBrowserMessage(channel, std::move(args_vector));
+}
+
+void JavascriptBindings::EmitBrowserMessage(
+    const base::string16& channel,
+    std::vector<v8::Local<v8::Value>> args_vector) {
+  v8::Isolate* isolate = context()->isolate();
 
   // Insert the Event object, event.sender is ipc
   mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
@@ -5,6 +5,10 @@
 #ifndef ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 #define ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "base/memory/shared_memory_handle.h"
 #include "content/public/renderer/render_view_observer.h"
 #include "extensions/renderer/object_backed_native_handler.h"
@@ -27,12 +31,20 @@ class JavascriptBindings : public content::RenderViewObserver,
   void GetBinding(const v8::FunctionCallbackInfo<v8::Value>& args);
 
  private:
-  base::string16 IPCSendSync(mate::Arguments* args,
+  v8::Local<v8::Value> IPCSendSync(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments);
   void IPCSend(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments);
+  void IPCSendTo(mate::Arguments* args,
+                 bool send_to_all,
+                 int32_t web_contents_id,
+                 const base::string16& channel,
+                 const base::ListValue& arguments);
+  void IPCSendStructured(mate::Arguments* args,
+                         const base::string16& channel,
+                         v8::Local<v8::Value> arguments);
   v8::Local<v8::Value> GetHiddenValue(v8::Isolate* isolate,
                                     v8::Local<v8::String> key);
   void SetHiddenValue(v8::Isolate* isolate,
@@ -62,6 +74,19 @@ class JavascriptBindings : public content::RenderViewObserver,
                         const base::ListValue& args);
   void OnSharedBrowserMessage(const base::string16& channel,
                               const base::SharedMemoryHandle& handle);
+  void OnStructuredBrowserMessage(bool all_frames,
+                                  const base::string16& channel,
+                                  const std::vector<uint8_t>& args);
+  void OnStructuredSharedBrowserMessage(bool all_frames,
+                                        const base::string16& channel,
+                                        int32_t id,
+                                        const base::SharedMemoryHandle& handle,
+                                        uint32_t size);
+  void EmitStructuredBrowserMessage(const base::string16& channel,
+                                    v8::MaybeLocal<v8::Value> args);
+  // ipcRenderer.emit(channel, event, args...)
+  void EmitBrowserMessage(const base::string16& channel,
+                          std::vector<v8::Local<v8::Value>> args_vector);
 
   DISALLOW_COPY_AND_ASSIGN(JavascriptBindings);
 };
@@ -4,6 +4,8 @@
 
 #include "atom/renderer/content_settings_manager.h"
 
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <vector>
 #include "atom/common/api/api_messages.h"
@@ -16,6 +18,39 @@
 
 namespace atom {
 
+namespace {
+
+// Bounds the memory used by the memoized settings of long running renderers.
+const size_t kMaxMatchedSettings = 1000;
+
+// The part of |url| the content settings patterns can match, only file
+// patterns have a path.
+std::string GetPatternMatchKey(const GURL& url) {
+  GURL origin = url.GetOrigin();
+  if (url.SchemeIsFile() || !origin.is_valid())
+    return url.spec();
+  return origin.spec();
+}
+
+}  // namespace
+
+ContentSettingsManager::CompiledRule::CompiledRule()
+    : first_party(false),
+      setting(CONTENT_SETTING_DEFAULT) {
+}
+
+ContentSettingsManager::CompiledRule::CompiledRule(
+    const CompiledRule& other) = default;
+
+ContentSettingsManager::CompiledRule::~CompiledRule() {
+}
+
+ContentSettingsManager::RuleIndex::RuleIndex() {
+}
+
+ContentSettingsManager::RuleIndex::~RuleIndex() {
+}
+
 ContentSettingsManager::ContentSettingsManager() {
   content::RenderThread::Get()->AddObserver(this);
 }
@@ -37,6 +72,8 @@ bool ContentSettingsManager::OnControlMessageReceived(
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(ContentSettingsManager, message)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettings, OnUpdateContentSettings)
+    IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettingsDelta,
+                        OnUpdateContentSettingsDelta)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateWebKitPrefs, OnUpdateWebKitPrefs)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
@@ -51,6 +88,88 @@ void ContentSettingsManager::OnUpdateWebKitPrefs(
 void ContentSettingsManager::OnUpdateContentSettings(
     const base::DictionaryValue& content_settings) {
   content_settings_ = content_settings.CreateDeepCopy();
+  rule_indexes_.clear();
+  matched_settings_.clear();
+  for (base::DictionaryValue::Iterator it(*content_settings_);
+       !it.IsAtEnd(); it.Advance()) {
+    CompileRules(it.key(), it.value());
+  }
+}
+
+void ContentSettingsManager::OnUpdateContentSettingsDelta(
+    const base::DictionaryValue& changed_types,
+    const std::vector<std::string>& removed_types) {
+  if (!content_settings_)
+    content_settings_.reset(new base::DictionaryValue);
+
+  matched_settings_.clear();
+  for (const auto& content_type : removed_types) {
+    content_settings_->RemoveWithoutPathExpansion(content_type, nullptr);
+    rule_indexes_.erase(content_type);
+  }
+  for (base::DictionaryValue::Iterator it(changed_types);
+       !it.IsAtEnd(); it.Advance()) {
+    content_settings_->SetWithoutPathExpansion(it.key(),
+                                               it.value().CreateDeepCopy());
+    rule_indexes_.erase(it.key());
+    CompileRules(it.key(), it.value());
+  }
+}
+
+void ContentSettingsManager::CompileRules(const std::string& content_type,
+                                          const base::Value& value) {
+  const base::ListValue* rules = nullptr;
+  if (!value.GetAsList(&rules))
+    return;
+
+  RuleIndex& index = rule_indexes_[content_type];
+  for (const auto& rule_value : *rules) {
+    const base::DictionaryValue* rule = nullptr;
+    std::string pattern_string;
+    std::string setting_string;
+    if (!rule_value.GetAsDictionary(&rule) ||
+        !rule->GetString("primaryPattern", &pattern_string) ||
+        !rule->GetString("setting", &setting_string)) {
+      // skip invalid entries
+      // TODO(bridiver) should also send an ipc error message
+      continue;
+    }
+
+    CompiledRule compiled;
+    compiled.primary_pattern = ContentSettingsPattern::FromString(
+        pattern_string);
+    // an invalid pattern never matches
+    if (!compiled.primary_pattern.IsValid())
+      continue;
+
+    std::string secondary_pattern_string;
+    rule->GetString("secondaryPattern", &secondary_pattern_string);
+    if (secondary_pattern_string == "[firstParty]") {
+      compiled.first_party = true;
+    } else if (!secondary_pattern_string.empty()) {
+      compiled.secondary_pattern = ContentSettingsPattern::FromString(
+          secondary_pattern_string);
+      if (!compiled.secondary_pattern.IsValid())
+        continue;
+    }
+
+    if (setting_string != "block" && setting_string != "deny") {
+      compiled.setting = ContentSetting::CONTENT_SETTING_ALLOW;
+    } else {
+      compiled.setting = ContentSetting::CONTENT_SETTING_BLOCK;
+    }
+
+    size_t rule_index = index.rules.size();
+    index.rules.push_back(compiled);
+
+    std::string host = compiled.primary_pattern.GetHost();
+    if (compiled.primary_pattern.MatchesAllHosts() || host.empty() ||
+        host[0] == '[') {
+      index.rules_for_any_host.push_back(rule_index);
+    } else {
+      index.rules_by_host[host].push_back(rule_index);
+    }
+  }
 }
 
 ContentSetting ContentSettingsManager::GetSetting(
@@ -86,6 +205,49 @@ std::vector<std::string> ContentSettingsManager::GetContentTypes() {
   return content_types;
 }
 
+ContentSetting ContentSettingsManager::MatchRules(
+    const RuleIndex& index,
+    const GURL& primary_url,
+    const GURL& secondary_url) {
+  // Host patterns are restricted to a host or, with a domain wildcard, to
+  // its subdomains too, so only the rules indexed by the host or one of its
+  // parent domains can match.
+  std::vector<size_t> candidates(index.rules_for_any_host);
+  std::string host = primary_url.host();
+  while (!host.empty()) {
+    auto it = index.rules_by_host.find(host);
+    if (it != index.rules_by_host.end())
+      candidates.insert(candidates.end(), it->second.begin(),
+                        it->second.end());
+    size_t dot = host.find('.');
+    if (dot == std::string::npos)
+      break;
+    host.erase(0, dot + 1);
+  }
+
+  // all rules are evaluated in order and the
+  // most specific matching rule will apply
+  std::sort(candidates.begin(), candidates.end(), std::greater<size_t>());
+  for (size_t rule_index : candidates) {
+    const CompiledRule& rule = index.rules[rule_index];
+    if (!rule.primary_pattern.Matches(primary_url))
+      continue;
+
+    // if there is a secondary resource pattern it has to match as well
+    if (rule.first_party) {
+      std::string primary_host = primary_url.HostNoBrackets();
+      if (primary_host.empty() || !secondary_url.DomainIs(primary_host))
+        continue;
+    } else if (rule.secondary_pattern.IsValid() &&
+               !rule.secondary_pattern.Matches(secondary_url)) {
+      continue;
+    }
+
+    return rule.setting;
+  }
+  return CONTENT_SETTING_DEFAULT;
+}
+
 ContentSetting ContentSettingsManager::GetContentSettingFromRules(
     const GURL& primary_url,
     const GURL& secondary_url,
@@ -95,47 +257,24 @@ ContentSetting ContentSettingsManager::GetContentSettingFromRules(
     ? ContentSetting::CONTENT_SETTING_ALLOW
     : ContentSetting::CONTENT_SETTING_BLOCK;
 
-  base::ListValue* rules = nullptr;
-  if (!content_settings_->GetList(content_type, &rules))
+  auto index = rule_indexes_.find(content_type);
+  if (index == rule_indexes_.end())
     return result;
 
-  // all rules are evaluated in order and the
-  // most specific matching rule will apply
-  for (base::ListValue::iterator it = rules->begin();
-       it != rules->end(); ++it) {
-    base::DictionaryValue* rule;
-    std::string pattern_string;
-    std::string setting_string;
-    if (!it->GetAsDictionary(&rule) ||
-        !rule->GetString("primaryPattern", &pattern_string) ||
-        !rule->GetString("setting", &setting_string)) {
-      // skip invalid entries
-      // TODO(bridiver) should also send an ipc error message
-      ++it;
-    } else {
-      std::string secondary_pattern_string;
-      rule->GetString("secondaryPattern", &secondary_pattern_string);
-
-      ContentSetting setting = result;
-      if (setting_string != "block" && setting_string != "deny") {
-        setting = ContentSetting::CONTENT_SETTING_ALLOW;
-      } else {
-        setting = ContentSetting::CONTENT_SETTING_BLOCK;
-      }
-
-      if (secondary_pattern_string == "[firstParty]") {
-        secondary_pattern_string = "[*.]" + primary_url.HostNoBrackets();
-      }
-
-      if (ContentSettingsPattern::FromString(
-            pattern_string).Matches(primary_url) &&
-          // if there is a secondary resource pattern it has to match as well
-          (secondary_pattern_string.empty() ||
-            ContentSettingsPattern::FromString(
-              secondary_pattern_string).Matches(secondary_url)))
-        result = setting;
-    }
+  std::string key = content_type + '\n' +
+                    GetPatternMatchKey(primary_url) + '\n' +
+                    GetPatternMatchKey(secondary_url);
+  auto matched = matched_settings_.find(key);
+  if (matched == matched_settings_.end()) {
+    if (matched_settings_.size() >= kMaxMatchedSettings)
+      matched_settings_.clear();
+    matched = matched_settings_.insert(std::make_pair(
+        key, MatchRules(index->second, primary_url, secondary_url))).first;
   }
+
+  if (matched->second != CONTENT_SETTING_DEFAULT)
+    result = matched->second;
   return result;
 }
+
 }  // namespace atom
@@ -5,11 +5,14 @@
 #ifndef ATOM_RENDERER_CONTENT_SETTINGS_MANAGER_H_
 #define ATOM_RENDERER_CONTENT_SETTINGS_MANAGER_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "base/values.h"
 #include "components/content_settings/core/common/content_settings.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
 #include "content/public/common/web_preferences.h"
 #include "content/public/renderer/render_thread_observer.h"
 
@@ -41,6 +44,40 @@ class ContentSettingsManager : public content::RenderThreadObserver {
   std::vector<std::string> GetContentTypes();
 
  private:
+  struct CompiledRule {
+    CompiledRule();
+    CompiledRule(const CompiledRule& other);
+    ~CompiledRule();
+
+    ContentSettingsPattern primary_pattern;
+    // Only valid if the rule has a secondary pattern.
+    ContentSettingsPattern secondary_pattern;
+    // Whether the secondary pattern is [firstParty].
+    bool first_party;
+    ContentSetting setting;
+  };
+
+  // The rules of a content type in order, indexed by the host their primary
+  // pattern is restricted to, if any.
+  struct RuleIndex {
+    RuleIndex();
+    ~RuleIndex();
+
+    std::vector<CompiledRule> rules;
+    std::unordered_map<std::string, std::vector<size_t>> rules_by_host;
+    std::vector<size_t> rules_for_any_host;
+  };
+
+  // Indexes the rules of |content_type| in |value|.
+  void CompileRules(const std::string& content_type,
+                    const base::Value& value);
+
+  // Returns the setting of the last rule matching the urls, or
+  // CONTENT_SETTING_DEFAULT if there is none.
+  ContentSetting MatchRules(const RuleIndex& index,
+                            const GURL& primary_url,
+                            const GURL& secondary_url);
+
   ContentSetting GetContentSettingFromRules(
     const GURL& primary_url,
     const GURL& secondary_url,
@@ -54,11 +91,20 @@ class ContentSettingsManager : public content::RenderThreadObserver {
       const content::WebPreferences& web_preferences);
   void OnUpdateContentSettings(
       const base::DictionaryValue& content_settings);
+  void OnUpdateContentSettingsDelta(
+      const base::DictionaryValue& changed_types,
+      const std::vector<std::string>& removed_types);
 
 
   content::WebPreferences web_preferences_;
   std::unique_ptr<base::DictionaryValue> content_settings_;
 
+  // Compiled from |content_settings_| and keyed by content type.
+  std::map<std::string, RuleIndex> rule_indexes_;
+  // Results of MatchRules keyed by content type and origins, cleared when the
+  // content settings are updated.
+  std::unordered_map<std::string, ContentSetting> matched_settings_;
+
   DISALLOW_COPY_AND_ASSIGN(ContentSettingsManager);
 };
 
@@ -0,0 +1,283 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/app_state_store.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_split.h"
+#include "base/threading/thread_restrictions.h"
+
+namespace brave {
+
+const char kAppStatePrefName[] = "app_state";
+
+namespace {
+
+const base::FilePath::CharType kJournalExtension[] =
+    FILE_PATH_LITERAL(" Journal");
+
+// Patches are batched for this long before being appended to the journal.
+const int kFlushDelayMs = 1000;
+
+// The journal is folded into the snapshot once it is larger than the
+// snapshot, and at least this large.
+const size_t kMinCompactionSize = 1024 * 1024;
+
+void AppendToJournal(const base::FilePath& path, const std::string& records) {
+  base::File file(path, base::File::FLAG_OPEN_ALWAYS |
+                        base::File::FLAG_APPEND);
+  if (!file.IsValid() ||
+      file.WriteAtCurrentPos(records.data(), records.size()) !=
+          static_cast<int>(records.size()) ||
+      !file.Flush()) {
+    LOG(WARNING) << "Failed to append app state to " << path.value();
+  }
+}
+
+// Reads the path of a journal record, an array of keys.
+bool ReadPath(const base::DictionaryValue& record, AppStateStore::Path* path) {
+  const base::ListValue* keys = nullptr;
+  if (!record.GetListWithoutPathExpansion("path", &keys))
+    return false;
+
+  for (const auto& key : *keys) {
+    std::string string;
+    if (!key->GetAsString(&string))
+      return false;
+    path->push_back(string);
+  }
+  return true;
+}
+
+void WriteSnapshot(const base::FilePath& snapshot_path,
+                   const base::FilePath& journal_path,
+                   const std::string& json) {
+  // The journal is only deleted once the snapshot that includes it is safely
+  // on disk.
+  if (!base::ImportantFileWriter::WriteFileAtomically(snapshot_path, json)) {
+    LOG(WARNING) << "Failed to write app state to " << snapshot_path.value();
+    return;
+  }
+  base::DeleteFile(journal_path, false);
+}
+
+}  // namespace
+
+const base::Value* FindValueAtPath(const base::Value& root,
+                                   const std::vector<std::string>& path) {
+  const base::Value* value = &root;
+  for (const auto& key : path) {
+    const base::DictionaryValue* dict = nullptr;
+    if (!value->GetAsDictionary(&dict) ||
+        !dict->GetWithoutPathExpansion(key, &value))
+      return nullptr;
+  }
+  return value;
+}
+
+void SetValueAtPath(base::DictionaryValue* root,
+                    const std::vector<std::string>& path,
+                    std::unique_ptr<base::Value> value) {
+  DCHECK(!path.empty());
+  base::DictionaryValue* dict = root;
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    base::DictionaryValue* child = nullptr;
+    if (!dict->GetDictionaryWithoutPathExpansion(path[i], &child)) {
+      if (!value)
+        return;
+      std::unique_ptr<base::DictionaryValue> new_child(
+          new base::DictionaryValue);
+      child = new_child.get();
+      dict->SetWithoutPathExpansion(path[i], std::move(new_child));
+    }
+    dict = child;
+  }
+
+  if (value)
+    dict->SetWithoutPathExpansion(path.back(), std::move(value));
+  else
+    dict->RemoveWithoutPathExpansion(path.back(), nullptr);
+}
+
+AppStateStore::AppStateStore(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : snapshot_path_(path),
+      journal_path_(path.InsertBeforeExtension(kJournalExtension)),
+      task_runner_(task_runner),
+      state_(new base::DictionaryValue),
+      snapshot_size_(0),
+      journal_size_(0) {
+}
+
+AppStateStore::AppStateStore(const base::DictionaryValue& state)
+    : state_(state.CreateDeepCopy()),
+      snapshot_size_(0),
+      journal_size_(0) {
+}
+
+AppStateStore::~AppStateStore() {
+  CommitPendingWrite();
+}
+
+void AppStateStore::Load() {
+  // Read synchronously like the user prefs, the state is needed right away.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+
+  std::string snapshot;
+  if (base::ReadFileToString(snapshot_path_, &snapshot)) {
+    std::unique_ptr<base::DictionaryValue> state =
+        base::DictionaryValue::From(base::JSONReader::Read(snapshot));
+    if (state)
+      state_ = std::move(state);
+    snapshot_size_ = snapshot.size();
+  }
+
+  std::string journal;
+  if (!base::ReadFileToString(journal_path_, &journal))
+    return;
+
+  bool truncated = false;
+  for (const auto& line : base::SplitStringPiece(
+           journal, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    std::unique_ptr<base::DictionaryValue> record =
+        base::DictionaryValue::From(base::JSONReader::Read(line));
+    Path path;
+    if (!record || !ReadPath(*record, &path)) {
+      // Only the last record can be incomplete, after a crash.
+      truncated = true;
+      break;
+    }
+
+    std::unique_ptr<base::Value> value;
+    record->RemoveWithoutPathExpansion("value", &value);
+    Apply(path, std::move(value));
+  }
+  journal_size_ = journal.size();
+
+  // Nothing can be appended after an incomplete record.
+  if (truncated ||
+      journal_size_ > std::max(kMinCompactionSize, snapshot_size_)) {
+    Compact();
+  }
+}
+
+const base::Value* AppStateStore::Get(const Path& path) const {
+  return FindValueAtPath(*state_, path);
+}
+
+void AppStateStore::Set(const Path& path,
+                        std::unique_ptr<base::Value> value) {
+  DCHECK(value);
+  if (path.empty() && !value->IsType(base::Value::Type::DICTIONARY))
+    return;
+
+  Append(path, value.get());
+  Apply(path, std::move(value));
+  for (Observer& observer : observers_)
+    observer.OnAppStateChanged(path);
+}
+
+void AppStateStore::Remove(const Path& path) {
+  if (!Get(path))
+    return;
+
+  Append(path, nullptr);
+  Apply(path, nullptr);
+  for (Observer& observer : observers_)
+    observer.OnAppStateChanged(path);
+}
+
+void AppStateStore::CommitPendingWrite() {
+  if (flush_timer_.IsRunning()) {
+    flush_timer_.Stop();
+    Flush();
+  }
+}
+
+void AppStateStore::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void AppStateStore::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+void AppStateStore::Apply(const Path& path,
+                          std::unique_ptr<base::Value> value) {
+  if (path.empty()) {
+    state_ = base::DictionaryValue::From(std::move(value));
+    if (!state_)
+      state_.reset(new base::DictionaryValue);
+    return;
+  }
+
+  SetValueAtPath(state_.get(), path, std::move(value));
+}
+
+void AppStateStore::Append(const Path& path, const base::Value* value) {
+  if (!task_runner_)
+    return;
+
+  std::unique_ptr<base::ListValue> keys(new base::ListValue);
+  keys->AppendStrings(path);
+  base::DictionaryValue record;
+  record.SetWithoutPathExpansion("path", std::move(keys));
+  if (value)
+    record.SetWithoutPathExpansion("value", value->CreateDeepCopy());
+
+  // The JSON writer escapes line breaks, so a record is always on one line.
+  std::string json;
+  base::JSONWriter::Write(record, &json);
+  pending_records_.append(json);
+  pending_records_.push_back('\n');
+
+  if (!flush_timer_.IsRunning()) {
+    flush_timer_.Start(FROM_HERE,
+                       base::TimeDelta::FromMilliseconds(kFlushDelayMs),
+                       base::Bind(&AppStateStore::Flush,
+                                  base::Unretained(this)));
+  }
+}
+
+void AppStateStore::Flush() {
+  if (pending_records_.empty())
+    return;
+
+  journal_size_ += pending_records_.size();
+  if (journal_size_ > std::max(kMinCompactionSize, snapshot_size_)) {
+    Compact();
+    return;
+  }
+
+  std::string records;
+  records.swap(pending_records_);
+  task_runner_->PostTask(FROM_HERE,
+                         base::Bind(&AppendToJournal, journal_path_, records));
+}
+
+void AppStateStore::Compact() {
+  // The snapshot includes the pending patches.
+  pending_records_.clear();
+  flush_timer_.Stop();
+
+  std::string json;
+  base::JSONWriter::Write(*state_, &json);
+  snapshot_size_ = json.size();
+  journal_size_ = 0;
+  task_runner_->PostTask(FROM_HERE,
+                         base::Bind(&WriteSnapshot, snapshot_path_,
+                                    journal_path_, json));
+}
+
+}  // namespace brave
@@ -0,0 +1,115 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_APP_STATE_STORE_H_
+#define BRAVE_BROWSER_APP_STATE_STORE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/observer_list.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace brave {
+
+// The pref the app state used to be stored in. The pref APIs still address
+// the app state by this name.
+extern const char kAppStatePrefName[];
+
+// Return or replace the value at |path| under |root|, walking dictionaries
+// by the keys of |path| as they are rather than splitting them at dots like
+// the path accessors of DictionaryValue do. Setting a value creates the
+// dictionaries leading to it, a null |value| removes it. Also used for the
+// entries of dictionary prefs.
+const base::Value* FindValueAtPath(const base::Value& root,
+                                   const std::vector<std::string>& path);
+void SetValueAtPath(base::DictionaryValue* root,
+                    const std::vector<std::string>& path,
+                    std::unique_ptr<base::Value> value);
+
+// Stores the application state as a snapshot plus a journal of the patches
+// applied since, so that a change only appends its path and value to disk
+// instead of rewriting the whole state. The journal is folded back into the
+// snapshot once it grows large.
+//
+// Both files are only ever appended to or atomically replaced, and replaying
+// the journal over a newer snapshot gives the same state, so a crash at any
+// point loses at most the patches that were not flushed yet.
+//
+// Lives on the UI thread, the files are written on |task_runner|.
+class AppStateStore {
+ public:
+  // The keys leading to a value of the state, taken as they are so that
+  // dotted ones like hostnames can be used. Empty for the whole state.
+  using Path = std::vector<std::string>;
+
+  class Observer {
+   public:
+    // Called after the value at |path| was set or removed.
+    virtual void OnAppStateChanged(const Path& path) = 0;
+
+   protected:
+    virtual ~Observer() {}
+  };
+
+  AppStateStore(const base::FilePath& path,
+                scoped_refptr<base::SequencedTaskRunner> task_runner);
+  // Keeps a copy of |state| in memory only, for off the record sessions.
+  explicit AppStateStore(const base::DictionaryValue& state);
+  ~AppStateStore();
+
+  // Reads the snapshot and replays the journal.
+  void Load();
+
+  bool IsEmpty() const { return state_->empty(); }
+  const base::DictionaryValue& state() const { return *state_; }
+
+  // Returns the value at |path|, or null if there is none.
+  const base::Value* Get(const Path& path) const;
+
+  // Replaces the value at |path|, creating the dictionaries leading to it.
+  // |value| must be a dictionary if |path| is empty.
+  void Set(const Path& path, std::unique_ptr<base::Value> value);
+  void Remove(const Path& path);
+
+  // Writes the pending patches now.
+  void CommitPendingWrite();
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+ private:
+  void Apply(const Path& path, std::unique_ptr<base::Value> value);
+  void Append(const Path& path, const base::Value* value);
+  void Flush();
+  void Compact();
+
+  base::FilePath snapshot_path_;
+  base::FilePath journal_path_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  std::unique_ptr<base::DictionaryValue> state_;
+  base::ObserverList<Observer> observers_;
+
+  // Patches not written to the journal yet, one JSON record per line.
+  std::string pending_records_;
+  size_t snapshot_size_;
+  size_t journal_size_;
+  base::OneShotTimer flush_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(AppStateStore);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_APP_STATE_STORE_H_
@@ -10,6 +10,7 @@
 #include "base/path_service.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "brave/browser/app_state_store.h"
 #include "brave/browser/brave_permission_manager.h"
 #include "brightray/browser/brightray_paths.h"
 #include "chrome/browser/browser_process.h"
@@ -94,6 +95,7 @@ namespace brave {
 
 const char kPersistPrefix[] = "persist:";
 const int kPersistPrefixLength = 8;
+const char kAppStateMigrated[] = "app_state_migrated";
 
 void DatabaseErrorCallback(sql::InitStatus init_status,
                            const std::string& diagnostics) {
@@ -185,6 +187,7 @@ BraveBrowserContext::~BraveBrowserContext() {
     if (prefs_loaded) {
       user_prefs_->CommitPendingWrite();
     }
+    app_state_store_->CommitPendingWrite();
   }
 
   BrowserContextDependencyManager::GetInstance()->
@@ -320,6 +323,27 @@ void BraveBrowserContext::UpdateDefaultZoomLevel() {
       ->OnDefaultZoomLevelChanged();
 }
 
+AppStateStore* BraveBrowserContext::app_state_store() {
+  // Like an overlay pref, off the record sessions read the persisted state
+  // until they change it.
+  if (IsOffTheRecord() && app_state_store_)
+    return app_state_store_.get();
+  return original_context()->app_state_store_.get();
+}
+
+AppStateStore* BraveBrowserContext::GetWritableAppStateStore() {
+  if (!IsOffTheRecord())
+    return app_state_store();
+
+  if (!app_state_store_) {
+    AppStateStore* original = original_context()->app_state_store_.get();
+    base::DictionaryValue empty;
+    app_state_store_.reset(
+        new AppStateStore(original ? original->state() : empty));
+  }
+  return app_state_store_.get();
+}
+
 content::PermissionManager* BraveBrowserContext::GetPermissionManager() {
   if (!permission_manager_.get())
     permission_manager_.reset(new BravePermissionManager);
@@ -381,7 +405,6 @@ void BraveBrowserContext::CreateProfilePrefs(
   bool async = false;
 
   if (IsOffTheRecord()) {
-    overlay_pref_names_.push_back("app_state");
     overlay_pref_names_.push_back(extensions::pref_names::kPrefContentSettings);
     overlay_pref_names_.push_back(prefs::kPartitionPerHostZoomLevels);
     user_prefs_.reset(
@@ -396,7 +419,7 @@ void BraveBrowserContext::CreateProfilePrefs(
               extension_prefs, overlay_pref_names));
     user_prefs::UserPrefs::Set(this, user_prefs_.get());
   } else {
-    pref_registry_->RegisterDictionaryPref("app_state");
+    pref_registry_->RegisterBooleanPref(kAppStateMigrated, false);
     pref_registry_->RegisterDictionaryPref(
         extensions::pref_names::kPrefContentSettings);
     pref_registry_->RegisterBooleanPref(
@@ -430,16 +453,20 @@ void BraveBrowserContext::CreateProfilePrefs(
     // create profile prefs
     base::FilePath filepath = GetPath().Append(
         FILE_PATH_LITERAL("UserPrefs"));
-    scoped_refptr<JsonPrefStore> pref_store =
+    user_pref_store_ =
         new JsonPrefStore(filepath, task_runner, std::unique_ptr<PrefFilter>());
 
     // prepare factory
     sync_preferences::PrefServiceSyncableFactory factory;
     factory.set_async(async);
     factory.set_extension_prefs(extension_prefs);
-    factory.set_user_prefs(pref_store);
+    factory.set_user_prefs(user_pref_store_);
     user_prefs_ = factory.CreateSyncable(pref_registry_.get());
     user_prefs::UserPrefs::Set(this, user_prefs_.get());
+
+    app_state_store_.reset(new AppStateStore(
+        GetPath().Append(FILE_PATH_LITERAL("App State")), task_runner));
+    app_state_store_->Load();
     if (async) {
       user_prefs_->AddPrefInitObserver(base::Bind(
           &BraveBrowserContext::OnPrefsLoaded, base::Unretained(this)));
@@ -467,6 +494,21 @@ void BraveBrowserContext::OnPrefsLoaded(bool success) {
     content::BrowserContext::GetDefaultStoragePartition(this)->
         GetDOMStorageContext()->SetSaveSessionStorageOnDisk();
 
+    // The app state used to be stored in the user prefs, move it out once
+    // so they don't have to be rewritten whenever it changes.
+    if (!user_prefs_->GetBoolean(kAppStateMigrated)) {
+      const base::Value* app_state = nullptr;
+      if (user_pref_store_->GetValue(kAppStatePrefName, &app_state) &&
+          app_state_store_->IsEmpty()) {
+        app_state_store_->Set(AppStateStore::Path(),
+                              app_state->CreateDeepCopy());
+      }
+      user_pref_store_->RemoveValue(
+          kAppStatePrefName, WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+      user_prefs_->SetBoolean(kAppStateMigrated, true);
+    }
+    user_pref_store_ = nullptr;
+
     // Initialize autofill db
     base::FilePath webDataPath = GetPath().Append(kWebDataFilename);
 
@@ -21,6 +21,7 @@
 #include "components/prefs/overlay_user_pref_store.h"
 #include "components/webdata/common/web_database_service.h"
 
+class JsonPrefStore;
 class PrefChangeRegistrar;
 
 namespace sync_preferences {
@@ -33,6 +34,7 @@ class PrefRegistrySyncable;
 
 namespace brave {
 
+class AppStateStore;
 class BravePermissionManager;
 
 class BraveBrowserContext : public Profile {
@@ -98,6 +100,11 @@ class BraveBrowserContext : public Profile {
   PrefChangeRegistrar* user_prefs_change_registrar() const override {
     return user_prefs_registrar_.get(); }
 
+  // The application state. Off the record contexts share the persisted one
+  // until they change it, from then on they keep their own copy in memory.
+  AppStateStore* app_state_store();
+  AppStateStore* GetWritableAppStateStore();
+
   const std::string& partition() const { return partition_; }
   std::string partition_with_prefix();
   base::WaitableEvent* ready() { return ready_.get(); }
@@ -130,6 +137,8 @@ class BraveBrowserContext : public Profile {
   scoped_refptr<user_prefs::PrefRegistrySyncable> pref_registry_;
   std::unique_ptr<sync_preferences::PrefServiceSyncable> user_prefs_;
   std::unique_ptr<PrefChangeRegistrar> user_prefs_registrar_;
+  // Only kept until the prefs are loaded, to migrate the app state.
+  scoped_refptr<JsonPrefStore> user_pref_store_;
   std::vector<const char*> overlay_pref_names_;
 
   std::unique_ptr<content::HostZoomMap::Subscription> track_zoom_subscription_;
@@ -137,6 +146,7 @@ class BraveBrowserContext : public Profile {
         parent_default_zoom_level_subscription_;
 
   std::unique_ptr<BravePermissionManager> permission_manager_;
+  std::unique_ptr<AppStateStore> app_state_store_;
 
   bool has_parent_;
   BraveBrowserContext* original_context_;
@@ -0,0 +1,416 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/net/no_state_prefetcher.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/memory/memory_pressure_monitor.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_util.h"
+#include "brave/browser/net/no_state_prefetcher_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
+#include "net/url_request/url_fetcher.h"
+#include "net/url_request/url_fetcher_response_writer.h"
+#include "net/url_request/url_request_status.h"
+
+using content::BrowserThread;
+
+namespace brave {
+
+namespace {
+
+const size_t kMaxConcurrentFetches = 4;
+const size_t kMaxPendingJobs = 64;
+const size_t kMaxSubresourcesPerPage = 32;
+// Only the beginning of the document is scanned for subresources, the rest
+// of the body is still read into the cache but not kept in memory.
+const size_t kMaxScannedBytes = 512 * 1024;
+const int kMemoryPressureBackoffSeconds = 60;
+
+// Keeps at most |limit| bytes of the response and discards the rest.
+class TruncatingResponseWriter : public net::URLFetcherResponseWriter {
+ public:
+  explicit TruncatingResponseWriter(size_t limit) : limit_(limit) {}
+
+  const std::string& data() const { return data_; }
+
+  // net::URLFetcherResponseWriter:
+  int Initialize(const net::CompletionCallback& callback) override {
+    data_.clear();
+    return net::OK;
+  }
+  int Write(net::IOBuffer* buffer,
+            int num_bytes,
+            const net::CompletionCallback& callback) override {
+    if (data_.size() < limit_) {
+      size_t length = std::min(limit_ - data_.size(),
+                               static_cast<size_t>(num_bytes));
+      data_.append(buffer->data(), length);
+    }
+    return num_bytes;
+  }
+  int Finish(int net_error, const net::CompletionCallback& callback) override {
+    return net::OK;
+  }
+
+ private:
+  const size_t limit_;
+  std::string data_;
+
+  DISALLOW_COPY_AND_ASSIGN(TruncatingResponseWriter);
+};
+
+bool IsWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+// Parses the attributes of the tag starting at |pos|, which points just past
+// the tag name, and returns the position of the closing '>'.
+size_t ParseAttributes(const std::string& html,
+                       size_t pos,
+                       std::map<std::string, std::string>* attributes) {
+  while (pos < html.size() && html[pos] != '>') {
+    if (IsWhitespace(html[pos]) || html[pos] == '/') {
+      ++pos;
+      continue;
+    }
+
+    size_t name_start = pos;
+    while (pos < html.size() && !IsWhitespace(html[pos]) &&
+           html[pos] != '=' && html[pos] != '>' && html[pos] != '/')
+      ++pos;
+    std::string name =
+        base::ToLowerASCII(html.substr(name_start, pos - name_start));
+
+    while (pos < html.size() && IsWhitespace(html[pos]))
+      ++pos;
+    std::string value;
+    if (pos < html.size() && html[pos] == '=') {
+      ++pos;
+      while (pos < html.size() && IsWhitespace(html[pos]))
+        ++pos;
+      if (pos < html.size() && (html[pos] == '"' || html[pos] == '\'')) {
+        char quote = html[pos++];
+        size_t end = html.find(quote, pos);
+        if (end == std::string::npos)
+          return std::string::npos;
+        value = html.substr(pos, end - pos);
+        pos = end + 1;
+      } else {
+        size_t value_start = pos;
+        while (pos < html.size() && !IsWhitespace(html[pos]) &&
+               html[pos] != '>')
+          ++pos;
+        value = html.substr(value_start, pos - value_start);
+      }
+    }
+    if (!name.empty())
+      attributes->insert(std::make_pair(name, value));
+  }
+  return pos < html.size() ? pos : std::string::npos;
+}
+
+void RunBothCallbacks(const NoStatePrefetcher::CompletionCallback& first,
+                      const NoStatePrefetcher::CompletionCallback& second,
+                      int error) {
+  first.Run(error);
+  second.Run(error);
+}
+
+}  // namespace
+
+NoStatePrefetcher::Job::Job() : is_main_resource(false) {}
+
+NoStatePrefetcher::Job::~Job() {}
+
+NoStatePrefetcher::NoStatePrefetcher(Profile* profile)
+    : profile_(profile),
+      memory_pressure_level_(
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&NoStatePrefetcher::OnMemoryPressure,
+                 base::Unretained(this))));
+}
+
+NoStatePrefetcher::~NoStatePrefetcher() {
+}
+
+// static
+NoStatePrefetcher* NoStatePrefetcher::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  return NoStatePrefetcherFactory::GetForBrowserContext(browser_context);
+}
+
+void NoStatePrefetcher::Prefetch(const GURL& url,
+                                 const GURL& referrer,
+                                 const CompletionCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  int error = net::OK;
+  if (!url.is_valid() || !url.SchemeIsHTTPOrHTTPS())
+    error = net::ERR_INVALID_URL;
+  else if (GetMemoryPressureLevel() ==
+           base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL)
+    error = net::ERR_INSUFFICIENT_RESOURCES;
+
+  if (error != net::OK) {
+    if (!callback.is_null())
+      callback.Run(error);
+    return;
+  }
+
+  Job* queued = FindJob(url);
+  if (queued) {
+    if (!callback.is_null()) {
+      queued->callback = queued->callback.is_null() ?
+          callback : base::Bind(&RunBothCallbacks, queued->callback, callback);
+    }
+    return;
+  }
+
+  std::unique_ptr<Job> job(new Job);
+  job->url = url;
+  job->referrer = referrer;
+  job->page_url = url;
+  job->is_main_resource = true;
+  job->callback = callback;
+  Enqueue(std::move(job));
+  StartPendingJobs();
+}
+
+void NoStatePrefetcher::Cancel(const GURL& url) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  std::vector<CompletionCallback> callbacks;
+  for (auto it = pending_jobs_.begin(); it != pending_jobs_.end();) {
+    if ((*it)->page_url == url) {
+      callbacks.push_back((*it)->callback);
+      it = pending_jobs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (auto it = active_jobs_.begin(); it != active_jobs_.end();) {
+    if (it->second->page_url == url) {
+      callbacks.push_back(it->second->callback);
+      it = active_jobs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  StartPendingJobs();
+
+  for (const auto& callback : callbacks) {
+    if (!callback.is_null())
+      callback.Run(net::ERR_ABORTED);
+  }
+}
+
+// static
+void NoStatePrefetcher::ExtractSubresourceURLs(const std::string& html,
+                                               const GURL& base_url,
+                                               std::vector<GURL>* urls) {
+  size_t pos = 0;
+  while (urls->size() < kMaxSubresourcesPerPage &&
+         (pos = html.find('<', pos)) != std::string::npos) {
+    ++pos;
+    if (html.compare(pos, 3, "!--") == 0) {
+      pos = html.find("-->", pos);
+      if (pos == std::string::npos)
+        return;
+      continue;
+    }
+
+    size_t name_start = pos;
+    while (pos < html.size() && base::IsAsciiAlpha(html[pos]))
+      ++pos;
+    std::string tag =
+        base::ToLowerASCII(html.substr(name_start, pos - name_start));
+    if (tag != "script" && tag != "link")
+      continue;
+
+    std::map<std::string, std::string> attributes;
+    pos = ParseAttributes(html, pos, &attributes);
+    if (pos == std::string::npos)
+      return;
+
+    std::string src;
+    if (tag == "script") {
+      src = attributes["src"];
+    } else {
+      std::string rel = base::ToLowerASCII(attributes["rel"]);
+      if (rel == "stylesheet" || rel == "preload")
+        src = attributes["href"];
+    }
+
+    GURL url = base_url.Resolve(
+        base::TrimWhitespaceASCII(src, base::TRIM_ALL).as_string());
+    if (!src.empty() && url.is_valid() && url.SchemeIsHTTPOrHTTPS())
+      urls->push_back(url);
+
+    // Skip over inline script bodies, they may contain markup.
+    if (tag == "script") {
+      size_t end = html.find("</script", pos);
+      if (end == std::string::npos)
+        return;
+      pos = end;
+    }
+  }
+}
+
+void NoStatePrefetcher::Shutdown() {
+  CancelAll(false);
+  backoff_timer_.Stop();
+  memory_pressure_listener_.reset();
+}
+
+void NoStatePrefetcher::OnURLFetchComplete(const net::URLFetcher* source) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = active_jobs_.find(source);
+  DCHECK(it != active_jobs_.end());
+  std::unique_ptr<Job> job = std::move(it->second);
+  active_jobs_.erase(it);
+
+  int error = source->GetStatus().error();
+  if (error == net::OK && source->GetResponseCode() >= 400)
+    error = net::ERR_FAILED;
+
+  if (job->is_main_resource && error == net::OK) {
+    auto writer = static_cast<const TruncatingResponseWriter*>(
+        source->GetResponseWriter());
+    std::vector<GURL> urls;
+    ExtractSubresourceURLs(writer->data(), source->GetURL(), &urls);
+    for (const auto& url : urls) {
+      if (IsQueued(url))
+        continue;
+      std::unique_ptr<Job> subresource(new Job);
+      subresource->url = url;
+      subresource->referrer = source->GetURL();
+      subresource->page_url = job->page_url;
+      Enqueue(std::move(subresource));
+    }
+  }
+
+  if (!job->callback.is_null())
+    job->callback.Run(error);
+
+  StartPendingJobs();
+}
+
+NoStatePrefetcher::Job* NoStatePrefetcher::FindJob(const GURL& url) const {
+  for (const auto& job : pending_jobs_) {
+    if (job->url == url)
+      return job.get();
+  }
+  for (const auto& it : active_jobs_) {
+    if (it.second->url == url)
+      return it.second.get();
+  }
+  return nullptr;
+}
+
+bool NoStatePrefetcher::IsQueued(const GURL& url) const {
+  return FindJob(url) != nullptr;
+}
+
+void NoStatePrefetcher::Enqueue(std::unique_ptr<Job> job) {
+  if (pending_jobs_.size() >= kMaxPendingJobs) {
+    if (!job->callback.is_null())
+      job->callback.Run(net::ERR_INSUFFICIENT_RESOURCES);
+    return;
+  }
+
+  // Subresources of pages that are already loading go first so a page is
+  // complete in the cache before the next one starts.
+  if (job->is_main_resource)
+    pending_jobs_.push_back(std::move(job));
+  else
+    pending_jobs_.push_front(std::move(job));
+}
+
+void NoStatePrefetcher::StartPendingJobs() {
+  while (!pending_jobs_.empty() &&
+         active_jobs_.size() < GetMaxConcurrentFetches()) {
+    std::unique_ptr<Job> job = std::move(pending_jobs_.front());
+    pending_jobs_.pop_front();
+
+    job->fetcher = net::URLFetcher::Create(job->url, net::URLFetcher::GET,
+                                           this);
+    job->fetcher->SetRequestContext(profile_->GetRequestContext());
+    job->fetcher->SetLoadFlags(net::LOAD_PREFETCH);
+    job->fetcher->SetReferrer(job->referrer.spec());
+    job->fetcher->SaveResponseWithWriter(base::WrapUnique(
+        new TruncatingResponseWriter(
+            job->is_main_resource ? kMaxScannedBytes : 0)));
+    job->fetcher->Start();
+
+    const net::URLFetcher* key = job->fetcher.get();
+    active_jobs_[key] = std::move(job);
+  }
+}
+
+size_t NoStatePrefetcher::GetMaxConcurrentFetches() const {
+  switch (GetMemoryPressureLevel()) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      return 0;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      return 1;
+    default:
+      return kMaxConcurrentFetches;
+  }
+}
+
+base::MemoryPressureListener::MemoryPressureLevel
+NoStatePrefetcher::GetMemoryPressureLevel() const {
+  auto monitor = base::MemoryPressureMonitor::Get();
+  if (monitor)
+    return monitor->GetCurrentPressureLevel();
+  return memory_pressure_level_;
+}
+
+void NoStatePrefetcher::CancelAll(bool notify) {
+  std::deque<std::unique_ptr<Job>> pending_jobs;
+  pending_jobs.swap(pending_jobs_);
+  std::map<const net::URLFetcher*, std::unique_ptr<Job>> active_jobs;
+  active_jobs.swap(active_jobs_);
+  if (!notify)
+    return;
+
+  for (const auto& job : pending_jobs) {
+    if (!job->callback.is_null())
+      job->callback.Run(net::ERR_ABORTED);
+  }
+  for (const auto& it : active_jobs) {
+    if (!it.second->callback.is_null())
+      it.second->callback.Run(net::ERR_ABORTED);
+  }
+}
+
+void NoStatePrefetcher::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  memory_pressure_level_ = memory_pressure_level;
+  if (memory_pressure_level !=
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+    backoff_timer_.Start(
+        FROM_HERE, base::TimeDelta::FromSeconds(kMemoryPressureBackoffSeconds),
+        base::Bind(&NoStatePrefetcher::OnMemoryPressure,
+                   base::Unretained(this),
+                   base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE));
+  }
+
+  if (memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL)
+    CancelAll(true);
+  else
+    StartPendingJobs();
+}
+
+}  // namespace brave
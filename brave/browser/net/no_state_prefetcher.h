@@ -0,0 +1,119 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_NET_NO_STATE_PREFETCHER_H_
+#define BRAVE_BROWSER_NET_NO_STATE_PREFETCHER_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/timer/timer.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "net/url_request/url_fetcher_delegate.h"
+#include "url/gurl.h"
+
+class Profile;
+
+namespace content {
+class BrowserContext;
+}
+
+namespace net {
+class URLFetcher;
+}
+
+namespace brave {
+
+// Warms the HTTP cache for pages the user is likely to visit next. The main
+// resource of the page is fetched and scanned for the scripts and style
+// sheets it references, which are then fetched as well. Nothing is rendered
+// and no script is run.
+//
+// Fetches run with a bounded concurrency, are throttled under moderate
+// memory pressure and dropped entirely under critical memory pressure.
+//
+// All methods must be called on the UI thread.
+class NoStatePrefetcher : public KeyedService,
+                          public net::URLFetcherDelegate {
+ public:
+  // Called with the net error of the main resource fetch.
+  using CompletionCallback = base::Callback<void(int)>;
+
+  explicit NoStatePrefetcher(Profile* profile);
+  ~NoStatePrefetcher() override;
+
+  static NoStatePrefetcher* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  // Queues a prefetch of the page at |url|. If |url| is already queued,
+  // |callback| gets the result of that fetch instead.
+  void Prefetch(const GURL& url,
+                const GURL& referrer,
+                const CompletionCallback& callback);
+
+  // Drops a queued or running prefetch of the page at |url|.
+  void Cancel(const GURL& url);
+
+  // Extracts the script and style sheet URLs referenced by |html|, resolved
+  // against |base_url|.
+  static void ExtractSubresourceURLs(const std::string& html,
+                                     const GURL& base_url,
+                                     std::vector<GURL>* urls);
+
+  // KeyedService:
+  void Shutdown() override;
+
+  // net::URLFetcherDelegate:
+  void OnURLFetchComplete(const net::URLFetcher* source) override;
+
+ private:
+  struct Job {
+    Job();
+    ~Job();
+
+    GURL url;
+    GURL referrer;
+    // The page this job was queued for.
+    GURL page_url;
+    bool is_main_resource;
+    CompletionCallback callback;
+    std::unique_ptr<net::URLFetcher> fetcher;
+  };
+
+  Job* FindJob(const GURL& url) const;
+  bool IsQueued(const GURL& url) const;
+  void Enqueue(std::unique_ptr<Job> job);
+  void StartPendingJobs();
+  size_t GetMaxConcurrentFetches() const;
+  base::MemoryPressureListener::MemoryPressureLevel
+      GetMemoryPressureLevel() const;
+  void CancelAll(bool notify);
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  Profile* profile_;  // not owned
+
+  std::deque<std::unique_ptr<Job>> pending_jobs_;
+  std::map<const net::URLFetcher*, std::unique_ptr<Job>> active_jobs_;
+
+  // The last level reported by |memory_pressure_listener_|, used when there
+  // is no MemoryPressureMonitor to ask. Pressure signals aren't followed by a
+  // "pressure is over" signal so the level is reset by |backoff_timer_|.
+  base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level_;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  base::OneShotTimer backoff_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(NoStatePrefetcher);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_NO_STATE_PREFETCHER_H_
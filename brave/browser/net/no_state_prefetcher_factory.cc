@@ -0,0 +1,46 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/net/no_state_prefetcher_factory.h"
+
+#include "base/memory/singleton.h"
+#include "brave/browser/net/no_state_prefetcher.h"
+#include "chrome/browser/profiles/incognito_helpers.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+
+namespace brave {
+
+// static
+NoStatePrefetcher* NoStatePrefetcherFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<NoStatePrefetcher*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+// static
+NoStatePrefetcherFactory* NoStatePrefetcherFactory::GetInstance() {
+  return base::Singleton<NoStatePrefetcherFactory>::get();
+}
+
+NoStatePrefetcherFactory::NoStatePrefetcherFactory()
+    : BrowserContextKeyedServiceFactory(
+        "NoStatePrefetcher",
+        BrowserContextDependencyManager::GetInstance()) {
+}
+
+NoStatePrefetcherFactory::~NoStatePrefetcherFactory() {
+}
+
+KeyedService* NoStatePrefetcherFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new NoStatePrefetcher(Profile::FromBrowserContext(context));
+}
+
+content::BrowserContext* NoStatePrefetcherFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  return chrome::GetBrowserContextOwnInstanceInIncognito(context);
+}
+
+}  // namespace brave
@@ -0,0 +1,44 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_NET_NO_STATE_PREFETCHER_FACTORY_H_
+#define BRAVE_BROWSER_NET_NO_STATE_PREFETCHER_FACTORY_H_
+
+#include "base/compiler_specific.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+#include "components/keyed_service/core/keyed_service.h"
+
+namespace base {
+template <typename T> struct DefaultSingletonTraits;
+}
+
+namespace brave {
+
+class NoStatePrefetcher;
+
+// Owns the NoStatePrefetcher of every profile. Incognito profiles get their
+// own prefetcher so they don't share the original profile's cache.
+class NoStatePrefetcherFactory : public BrowserContextKeyedServiceFactory {
+ public:
+  static NoStatePrefetcher* GetForBrowserContext(
+      content::BrowserContext* context);
+
+  static NoStatePrefetcherFactory* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<NoStatePrefetcherFactory>;
+
+  NoStatePrefetcherFactory();
+  ~NoStatePrefetcherFactory() override;
+
+  // BrowserContextKeyedServiceFactory:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_NO_STATE_PREFETCHER_FACTORY_H_
@@ -0,0 +1,317 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/net/preconnect_predictor.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/memory/ptr_util.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
+#include "brave/browser/net/preconnect_predictor_factory.h"
+#include "chrome/browser/history/history_service_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/history/core/browser/history_service.h"
+#include "components/prefs/pref_service.h"
+#include "components/prefs/scoped_user_pref_update.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/resource_context.h"
+#include "content/public/browser/resource_hints.h"
+#include "net/base/net_errors.h"
+#include "net/dns/host_resolver.h"
+#include "net/http/http_request_info.h"
+
+using content::BrowserThread;
+
+namespace brave {
+
+namespace {
+
+// Scores are an exponential moving average of "this origin was needed by a
+// navigation to the referring host", so they approximate a probability.
+const double kScoreDecay = 0.66;
+const double kPreconnectThreshold = 0.6;
+const double kPreresolveThreshold = 0.25;
+const double kDiscardThreshold = 0.05;
+
+const size_t kMaxReferrers = 500;
+const size_t kMaxSubresourcesPerReferrer = 16;
+const int kSaveDelaySeconds = 30;
+
+bool IsPredictableURL(const GURL& url) {
+  return url.is_valid() && url.SchemeIsHTTPOrHTTPS() && !url.host().empty();
+}
+
+void OnPreresolveCompleteOnIOThread(
+    std::unique_ptr<net::HostResolver::Request>* request,
+    int result) {
+  // The request can't be deleted from inside its own callback.
+  base::ThreadTaskRunnerHandle::Get()->DeleteSoon(FROM_HERE, request);
+}
+
+void WarmUpOnIOThread(content::ResourceContext* resource_context,
+                      const GURL& origin,
+                      const GURL& first_party,
+                      bool preconnect) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (preconnect) {
+    content::PreconnectUrl(resource_context, origin, first_party, 1, true,
+                           net::HttpRequestInfo::PRECONNECT_MOTIVATED);
+    return;
+  }
+
+  auto request = new std::unique_ptr<net::HostResolver::Request>;
+  int result = content::PreresolveUrl(
+      resource_context, origin,
+      base::Bind(&OnPreresolveCompleteOnIOThread, request), request);
+  if (result != net::ERR_IO_PENDING)
+    delete request;
+}
+
+}  // namespace
+
+PreconnectPredictor::Referrer::Referrer() {}
+
+PreconnectPredictor::Referrer::Referrer(const Referrer& other) = default;
+
+PreconnectPredictor::Referrer::~Referrer() {}
+
+PreconnectPredictor::PreconnectPredictor(Profile* profile)
+    : profile_(profile),
+      history_observer_(this) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  LoadFromPrefs();
+
+  history::HistoryService* history_service =
+      HistoryServiceFactory::GetForProfile(
+          profile_, ServiceAccessType::EXPLICIT_ACCESS);
+  if (history_service)
+    history_observer_.Add(history_service);
+}
+
+PreconnectPredictor::~PreconnectPredictor() {
+}
+
+// static
+PreconnectPredictor* PreconnectPredictor::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  return PreconnectPredictorFactory::GetForBrowserContext(browser_context);
+}
+
+void PreconnectPredictor::OnNavigationStarted(const GURL& url) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!IsPredictableURL(url))
+    return;
+
+  auto it = referrers_.find(url.host());
+  if (it == referrers_.end()) {
+    referrers_[url.host()].last_used = base::Time::Now();
+    TrimReferrers();
+    return;
+  }
+
+  Referrer& referrer = it->second;
+  WarmUpSubresources(url.host(), url);
+
+  referrer.seen.clear();
+  referrer.last_used = base::Time::Now();
+  for (auto sub = referrer.subresources.begin();
+       sub != referrer.subresources.end();) {
+    sub->second *= kScoreDecay;
+    if (sub->second < kDiscardThreshold)
+      sub = referrer.subresources.erase(sub);
+    else
+      ++sub;
+  }
+  ScheduleSave();
+}
+
+void PreconnectPredictor::OnResourceLoaded(const GURL& document_url,
+                                           const GURL& resource_url) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!IsPredictableURL(document_url) || !IsPredictableURL(resource_url))
+    return;
+
+  auto it = referrers_.find(document_url.host());
+  if (it == referrers_.end())
+    return;
+
+  Referrer& referrer = it->second;
+  GURL origin = resource_url.GetOrigin();
+  if (!referrer.seen.insert(origin).second)
+    return;
+
+  auto sub = referrer.subresources.find(origin);
+  if (sub != referrer.subresources.end()) {
+    sub->second += 1.0 - kScoreDecay;
+  } else if (referrer.subresources.size() < kMaxSubresourcesPerReferrer) {
+    referrer.subresources[origin] = 1.0 - kScoreDecay;
+  } else {
+    // Replace the weakest entry if the table for this host is full.
+    auto weakest = std::min_element(
+        referrer.subresources.begin(), referrer.subresources.end(),
+        [](const SubresourceMap::value_type& a,
+           const SubresourceMap::value_type& b) {
+          return a.second < b.second;
+        });
+    if (weakest->second >= 1.0 - kScoreDecay)
+      return;
+    referrer.subresources.erase(weakest);
+    referrer.subresources[origin] = 1.0 - kScoreDecay;
+  }
+  ScheduleSave();
+}
+
+void PreconnectPredictor::PreconnectUrlAndSubresources(const GURL& url) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!IsPredictableURL(url))
+    return;
+
+  WarmUp(url.GetOrigin(), url, true);
+  WarmUpSubresources(url.host(), url);
+}
+
+void PreconnectPredictor::ClearLearnedTable() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  referrers_.clear();
+  save_timer_.Stop();
+  SaveToPrefs();
+}
+
+void PreconnectPredictor::Shutdown() {
+  history_observer_.RemoveAll();
+  if (save_timer_.IsRunning()) {
+    save_timer_.Stop();
+    SaveToPrefs();
+  }
+}
+
+void PreconnectPredictor::OnURLsDeleted(
+    history::HistoryService* history_service,
+    bool all_history,
+    bool expired,
+    const history::URLRows& deleted_rows,
+    const std::set<GURL>& favicon_urls) {
+  // Expiration of old visits is routine and shouldn't forget what we learned.
+  if (expired)
+    return;
+
+  if (all_history) {
+    ClearLearnedTable();
+    return;
+  }
+
+  for (const auto& row : deleted_rows)
+    referrers_.erase(row.url().host());
+  ScheduleSave();
+}
+
+void PreconnectPredictor::WarmUp(const GURL& origin,
+                                 const GURL& first_party,
+                                 bool preconnect) {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&WarmUpOnIOThread,
+                 profile_->GetResourceContext(),
+                 origin,
+                 first_party,
+                 preconnect));
+}
+
+void PreconnectPredictor::WarmUpSubresources(const std::string& host,
+                                             const GURL& first_party) {
+  auto it = referrers_.find(host);
+  if (it == referrers_.end())
+    return;
+
+  for (const auto& sub : it->second.subresources) {
+    if (sub.second >= kPreconnectThreshold)
+      WarmUp(sub.first, first_party, true);
+    else if (sub.second >= kPreresolveThreshold)
+      WarmUp(sub.first, first_party, false);
+  }
+}
+
+void PreconnectPredictor::TrimReferrers() {
+  while (referrers_.size() > kMaxReferrers) {
+    auto oldest = std::min_element(
+        referrers_.begin(), referrers_.end(),
+        [](const ReferrerMap::value_type& a, const ReferrerMap::value_type& b) {
+          return a.second.last_used < b.second.last_used;
+        });
+    referrers_.erase(oldest);
+  }
+}
+
+void PreconnectPredictor::LoadFromPrefs() {
+  if (profile_->IsOffTheRecord())
+    return;
+
+  const base::DictionaryValue* table =
+      profile_->GetPrefs()->GetDictionary(kPreconnectPredictorTable);
+  for (base::DictionaryValue::Iterator it(*table); !it.IsAtEnd();
+       it.Advance()) {
+    const base::DictionaryValue* entry = nullptr;
+    if (!it.value().GetAsDictionary(&entry))
+      continue;
+
+    Referrer& referrer = referrers_[it.key()];
+    double last_used = 0;
+    if (entry->GetDouble("lastUsed", &last_used))
+      referrer.last_used = base::Time::FromJsTime(last_used);
+
+    const base::DictionaryValue* subresources = nullptr;
+    if (!entry->GetDictionary("subresources", &subresources))
+      continue;
+    for (base::DictionaryValue::Iterator sub(*subresources); !sub.IsAtEnd();
+         sub.Advance()) {
+      GURL origin(sub.key());
+      double score = 0;
+      if (IsPredictableURL(origin) && sub.value().GetAsDouble(&score) &&
+          score >= kDiscardThreshold &&
+          referrer.subresources.size() < kMaxSubresourcesPerReferrer)
+        referrer.subresources[origin] = score;
+    }
+  }
+  TrimReferrers();
+}
+
+void PreconnectPredictor::SaveToPrefs() {
+  if (profile_->IsOffTheRecord())
+    return;
+
+  DictionaryPrefUpdate update(profile_->GetPrefs(), kPreconnectPredictorTable);
+  base::DictionaryValue* table = update.Get();
+  table->Clear();
+  for (const auto& it : referrers_) {
+    if (it.second.subresources.empty())
+      continue;
+
+    auto subresources = base::MakeUnique<base::DictionaryValue>();
+    for (const auto& sub : it.second.subresources) {
+      // Origins contain dots, so don't use the path expanding setters.
+      subresources->SetDoubleWithoutPathExpansion(sub.first.spec(),
+                                                  sub.second);
+    }
+
+    auto entry = base::MakeUnique<base::DictionaryValue>();
+    entry->SetDouble("lastUsed", it.second.last_used.ToJsTime());
+    entry->Set("subresources", std::move(subresources));
+    table->SetWithoutPathExpansion(it.first, std::move(entry));
+  }
+}
+
+void PreconnectPredictor::ScheduleSave() {
+  if (profile_->IsOffTheRecord() || save_timer_.IsRunning())
+    return;
+
+  save_timer_.Start(FROM_HERE,
+                    base::TimeDelta::FromSeconds(kSaveDelaySeconds),
+                    base::Bind(&PreconnectPredictor::SaveToPrefs,
+                               base::Unretained(this)));
+}
+
+}  // namespace brave
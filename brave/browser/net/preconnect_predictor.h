@@ -0,0 +1,109 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_NET_PRECONNECT_PREDICTOR_H_
+#define BRAVE_BROWSER_NET_PRECONNECT_PREDICTOR_H_
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "base/macros.h"
+#include "base/scoped_observer.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "components/history/core/browser/history_service_observer.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "url/gurl.h"
+
+class Profile;
+
+namespace content {
+class BrowserContext;
+}
+
+namespace history {
+class HistoryService;
+}
+
+namespace brave {
+
+// Learns which origins a navigation to a given host usually needs and warms
+// them up (DNS resolution and socket preconnects) the next time that host is
+// navigated to. The learned table is kept per profile, persisted in the
+// profile prefs for regular profiles and cleared along with history.
+//
+// All methods must be called on the UI thread.
+class PreconnectPredictor : public KeyedService,
+                            public history::HistoryServiceObserver {
+ public:
+  explicit PreconnectPredictor(Profile* profile);
+  ~PreconnectPredictor() override;
+
+  static PreconnectPredictor* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  // Called when a main frame navigation to |url| starts. Decays the learned
+  // scores for the host and warms up the origins it is expected to need.
+  void OnNavigationStarted(const GURL& url);
+
+  // Records that the page at |document_url| loaded a resource from
+  // |resource_url|.
+  void OnResourceLoaded(const GURL& document_url, const GURL& resource_url);
+
+  // Warms up |url| itself and the origins learned for its host, e.g. when the
+  // user hovers an omnibox suggestion.
+  void PreconnectUrlAndSubresources(const GURL& url);
+
+  // Drops every learned entry, including the persisted copy.
+  void ClearLearnedTable();
+
+  // KeyedService:
+  void Shutdown() override;
+
+  // history::HistoryServiceObserver:
+  void OnURLsDeleted(history::HistoryService* history_service,
+                     bool all_history,
+                     bool expired,
+                     const history::URLRows& deleted_rows,
+                     const std::set<GURL>& favicon_urls) override;
+
+ private:
+  // Expected-use score of every subresource origin, keyed by origin.
+  using SubresourceMap = std::map<GURL, double>;
+
+  struct Referrer {
+    Referrer();
+    Referrer(const Referrer& other);
+    ~Referrer();
+
+    SubresourceMap subresources;
+    // Origins already credited since the last navigation to this host.
+    std::set<GURL> seen;
+    base::Time last_used;
+  };
+
+  using ReferrerMap = std::map<std::string, Referrer>;
+
+  void WarmUp(const GURL& origin, const GURL& first_party, bool preconnect);
+  void WarmUpSubresources(const std::string& host, const GURL& first_party);
+  void TrimReferrers();
+
+  void LoadFromPrefs();
+  void SaveToPrefs();
+  void ScheduleSave();
+
+  Profile* profile_;  // not owned
+  ReferrerMap referrers_;
+  base::OneShotTimer save_timer_;
+
+  ScopedObserver<history::HistoryService, history::HistoryServiceObserver>
+      history_observer_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreconnectPredictor);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_PRECONNECT_PREDICTOR_H_
@@ -0,0 +1,56 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/net/preconnect_predictor_factory.h"
+
+#include "base/memory/singleton.h"
+#include "brave/browser/net/preconnect_predictor.h"
+#include "chrome/browser/history/history_service_factory.h"
+#include "chrome/browser/profiles/incognito_helpers.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+#include "components/pref_registry/pref_registry_syncable.h"
+
+namespace brave {
+
+const char kPreconnectPredictorTable[] = "net.preconnect_predictor";
+
+// static
+PreconnectPredictor* PreconnectPredictorFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<PreconnectPredictor*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+// static
+PreconnectPredictorFactory* PreconnectPredictorFactory::GetInstance() {
+  return base::Singleton<PreconnectPredictorFactory>::get();
+}
+
+PreconnectPredictorFactory::PreconnectPredictorFactory()
+    : BrowserContextKeyedServiceFactory(
+        "PreconnectPredictor",
+        BrowserContextDependencyManager::GetInstance()) {
+  DependsOn(HistoryServiceFactory::GetInstance());
+}
+
+PreconnectPredictorFactory::~PreconnectPredictorFactory() {
+}
+
+KeyedService* PreconnectPredictorFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new PreconnectPredictor(Profile::FromBrowserContext(context));
+}
+
+content::BrowserContext* PreconnectPredictorFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  return chrome::GetBrowserContextOwnInstanceInIncognito(context);
+}
+
+void PreconnectPredictorFactory::RegisterProfilePrefs(
+    user_prefs::PrefRegistrySyncable* registry) {
+  registry->RegisterDictionaryPref(kPreconnectPredictorTable);
+}
+
+}  // namespace brave
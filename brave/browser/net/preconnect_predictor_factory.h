@@ -0,0 +1,53 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_NET_PRECONNECT_PREDICTOR_FACTORY_H_
+#define BRAVE_BROWSER_NET_PRECONNECT_PREDICTOR_FACTORY_H_
+
+#include "base/compiler_specific.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+#include "components/keyed_service/core/keyed_service.h"
+
+namespace base {
+template <typename T> struct DefaultSingletonTraits;
+}
+
+namespace user_prefs {
+class PrefRegistrySyncable;
+}
+
+namespace brave {
+
+class PreconnectPredictor;
+
+// Dictionary pref holding the learned host -> subresource origins table.
+extern const char kPreconnectPredictorTable[];
+
+// Owns the PreconnectPredictor of every profile. Incognito profiles get their
+// own predictor which is never persisted.
+class PreconnectPredictorFactory : public BrowserContextKeyedServiceFactory {
+ public:
+  static PreconnectPredictor* GetForBrowserContext(
+      content::BrowserContext* context);
+
+  static PreconnectPredictorFactory* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<PreconnectPredictorFactory>;
+
+  PreconnectPredictorFactory();
+  ~PreconnectPredictorFactory() override;
+
+  // BrowserContextKeyedServiceFactory:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+  void RegisterProfilePrefs(
+      user_prefs::PrefRegistrySyncable* registry) override;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_PRECONNECT_PREDICTOR_FACTORY_H_
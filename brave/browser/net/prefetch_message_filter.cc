@@ -0,0 +1,96 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/net/prefetch_message_filter.h"
+
+#include "brave/browser/net/no_state_prefetcher.h"
+#include "chrome/common/prerender_messages.h"
+#include "content/public/browser/render_process_host.h"
+
+using content::BrowserThread;
+
+namespace brave {
+
+PrefetchMessageFilter::PrefetchMessageFilter(int render_process_id)
+    : BrowserMessageFilter(PrerenderMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+PrefetchMessageFilter::~PrefetchMessageFilter() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+}
+
+bool PrefetchMessageFilter::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(PrefetchMessageFilter, message)
+    IPC_MESSAGE_HANDLER(PrerenderHostMsg_AddLinkRelPrerender,
+                        OnAddLinkRelPrerender)
+    IPC_MESSAGE_HANDLER(PrerenderHostMsg_CancelLinkRelPrerender,
+                        OnCancelLinkRelPrerender)
+    IPC_MESSAGE_HANDLER(PrerenderHostMsg_AbandonLinkRelPrerender,
+                        OnAbandonLinkRelPrerender)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+
+  return handled;
+}
+
+void PrefetchMessageFilter::OverrideThreadForMessage(
+    const IPC::Message& message, BrowserThread::ID* thread) {
+  if (IPC_MESSAGE_CLASS(message) == PrerenderMsgStart)
+    *thread = BrowserThread::UI;
+}
+
+void PrefetchMessageFilter::OnDestruct() const {
+  // |prefetches_| is only touched on the UI thread.
+  BrowserThread::DeleteOnUIThread::Destruct(this);
+}
+
+void PrefetchMessageFilter::OnAddLinkRelPrerender(
+    int prerender_id,
+    const PrerenderAttributes& attributes,
+    const content::Referrer& referrer,
+    const gfx::Size& size,
+    int render_view_route_id) {
+  content::RenderProcessHost* host =
+      content::RenderProcessHost::FromID(render_process_id_);
+  if (!host)
+    return;
+
+  auto prefetcher =
+      NoStatePrefetcher::FromBrowserContext(host->GetBrowserContext());
+  if (!prefetcher)
+    return;
+
+  prefetches_[prerender_id] = attributes.url;
+  prefetcher->Prefetch(attributes.url, referrer.url,
+                       NoStatePrefetcher::CompletionCallback());
+}
+
+void PrefetchMessageFilter::OnCancelLinkRelPrerender(int prerender_id) {
+  auto it = prefetches_.find(prerender_id);
+  if (it == prefetches_.end())
+    return;
+
+  GURL url = it->second;
+  prefetches_.erase(it);
+
+  content::RenderProcessHost* host =
+      content::RenderProcessHost::FromID(render_process_id_);
+  if (!host)
+    return;
+
+  auto prefetcher =
+      NoStatePrefetcher::FromBrowserContext(host->GetBrowserContext());
+  if (prefetcher)
+    prefetcher->Cancel(url);
+}
+
+void PrefetchMessageFilter::OnAbandonLinkRelPrerender(int prerender_id) {
+  // The page that added the hint went away, but the user may still follow
+  // the link so let the prefetch finish.
+  prefetches_.erase(prerender_id);
+}
+
+}  // namespace brave
@@ -0,0 +1,61 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_NET_PREFETCH_MESSAGE_FILTER_H_
+#define BRAVE_BROWSER_NET_PREFETCH_MESSAGE_FILTER_H_
+
+#include <map>
+
+#include "content/public/browser/browser_message_filter.h"
+#include "url/gurl.h"
+
+struct PrerenderAttributes;
+
+namespace content {
+struct Referrer;
+}
+
+namespace gfx {
+class Size;
+}
+
+namespace brave {
+
+// Turns the <link rel=prerender> hints sent by the renderer's
+// PrerenderDispatcher into prefetches on the profile's NoStatePrefetcher.
+class PrefetchMessageFilter : public content::BrowserMessageFilter {
+ public:
+  explicit PrefetchMessageFilter(int render_process_id);
+
+  // content::BrowserMessageFilter:
+  bool OnMessageReceived(const IPC::Message& message) override;
+  void OverrideThreadForMessage(const IPC::Message& message,
+                                content::BrowserThread::ID* thread) override;
+  void OnDestruct() const override;
+
+ private:
+  friend class base::DeleteHelper<PrefetchMessageFilter>;
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::UI>;
+
+  ~PrefetchMessageFilter() override;
+
+  void OnAddLinkRelPrerender(int prerender_id,
+                             const PrerenderAttributes& attributes,
+                             const content::Referrer& referrer,
+                             const gfx::Size& size,
+                             int render_view_route_id);
+  void OnCancelLinkRelPrerender(int prerender_id);
+  void OnAbandonLinkRelPrerender(int prerender_id);
+
+  const int render_process_id_;
+  // Hinted URLs by prerender id so a cancelled hint drops its prefetch.
+  std::map<int, GURL> prefetches_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrefetchMessageFilter);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_PREFETCH_MESSAGE_FILTER_H_
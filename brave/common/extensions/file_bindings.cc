@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -14,6 +15,7 @@
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "brave/common/converters/string16_converter.h"
+#include "components/compression/compression_utils.h"
 #include "content/public/browser/browser_thread.h"
 #include "extensions/renderer/script_context.h"
 #include "extensions/renderer/v8_helpers.h"
@@ -25,6 +27,10 @@ namespace brave {
 
 namespace {
 
+// Writes of the same file within options.delay are coalesced, there is no
+// delay by default.
+const int kDefaultWriteDelayMs = 0;
+
 void PostWriteCallback(
     const base::Callback<void(bool success)>& callback,
     scoped_refptr<base::SequencedTaskRunner> reply_task_runner,
@@ -37,13 +43,105 @@ void PostWriteCallback(
 
 }  // namespace
 
+// Keeps the latest data written to a file until its write is due.
+class FileBindings::Writer
+    : public base::ImportantFileWriter::DataSerializer {
+ public:
+  Writer(FileBindings* bindings, const base::FilePath& path)
+      : bindings_(bindings),
+        path_(path),
+        task_runner_(GetTaskRunnerForFile(path,
+                                          BrowserThread::GetBlockingPool())),
+        compress_(false),
+        writes_in_flight_(0) {
+  }
+
+  void Write(const std::string& data,
+             bool compress,
+             base::TimeDelta delay,
+             std::unique_ptr<v8::Global<v8::Function>> callback) {
+    if (!writer_ || writer_->commit_interval() != delay) {
+      Flush();
+      writer_.reset(new base::ImportantFileWriter(path_, task_runner_, delay));
+    }
+
+    data_ = data;
+    compress_ = compress;
+    if (callback)
+      callbacks_.push_back(std::move(callback));
+
+    writer_->ScheduleWrite(this);
+    if (delay.is_zero())
+      writer_->DoScheduledWrite();
+  }
+
+  void Flush() {
+    if (writer_ && writer_->HasPendingWrite())
+      writer_->DoScheduledWrite();
+  }
+
+  void OnWriteDone() { --writes_in_flight_; }
+
+  bool IsIdle() const {
+    return !writes_in_flight_ && !(writer_ && writer_->HasPendingWrite());
+  }
+
+  // base::ImportantFileWriter::DataSerializer:
+  bool SerializeData(std::string* data) override {
+    ++writes_in_flight_;
+
+    // The callbacks of all the coalesced writes run once the data is on
+    // disk, always from a task of their own.
+    base::Callback<void(bool)> done =
+        base::Bind(&FileBindings::OnWriteDone, bindings_->AsWeakPtr(), path_,
+                   base::Passed(&callbacks_));
+    callbacks_.clear();
+
+    bool success = true;
+    if (compress_)
+      success = compression::GzipCompress(data_, data);
+    else
+      data->swap(data_);
+    data_.clear();
+
+    if (!success) {
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::Bind(done, false));
+      return false;
+    }
+
+    writer_->RegisterOnNextWriteCallbacks(
+        base::Closure(),
+        base::Bind(&PostWriteCallback, done,
+                   base::SequencedTaskRunnerHandle::Get()));
+    return true;
+  }
+
+ private:
+  FileBindings* bindings_;  // owner
+  const base::FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  // Recreated when the delay changes, it can't be changed afterwards.
+  std::unique_ptr<base::ImportantFileWriter> writer_;
+  std::string data_;
+  bool compress_;
+  std::vector<std::unique_ptr<v8::Global<v8::Function>>> callbacks_;
+  int writes_in_flight_;
+
+  DISALLOW_COPY_AND_ASSIGN(Writer);
+};
+
 FileBindings::FileBindings(extensions::ScriptContext* context)
     : extensions::ObjectBackedNativeHandler(context) {
   RouteFunction("WriteImportantFile",
       base::Bind(&FileBindings::WriteImportantFile, base::Unretained(this)));
+  RouteFunction("Flush",
+      base::Bind(&FileBindings::Flush, base::Unretained(this)));
 }
 
 FileBindings::~FileBindings() {
+  // Don't lose the pending writes, their callbacks won't run anymore.
+  FlushAll();
 }
 
 // static
@@ -56,6 +154,8 @@ v8::Local<v8::Object> FileBindings::API(
   v8::Local<v8::Object> file_api = v8::Object::New(context->isolate());
   context->module_system()->SetNativeLazyField(
         file_api, "writeImportant", "muon_file", "WriteImportantFile");
+  context->module_system()->SetNativeLazyField(
+        file_api, "flush", "muon_file", "Flush");
 
   return file_api;
 }
@@ -83,6 +183,7 @@ void FileBindings::WriteImportantFile(
   if (!path.IsAbsolute()) {
     isolate->ThrowException(v8::String::NewFromUtf8(
         isolate, "`path` must be absolute"));
+    return;
   }
 
   if (!args[1]->IsString()) {
@@ -92,25 +193,45 @@ void FileBindings::WriteImportantFile(
   }
   std::string data = *v8::String::Utf8Value(args[1]);
 
+  int next_arg = 2;
+  int delay_ms = kDefaultWriteDelayMs;
+  bool compress = false;
+  if (args.Length() > next_arg && args[next_arg]->IsObject() &&
+      !args[next_arg]->IsFunction()) {
+    auto v8_context = context()->v8_context();
+    auto options = args[next_arg].As<v8::Object>();
+    v8::Local<v8::Value> value;
+    if (extensions::v8_helpers::GetProperty(
+            v8_context, options, "delay", &value) && value->IsNumber()) {
+      delay_ms = std::max(0, static_cast<int>(value.As<v8::Number>()->Value()));
+    }
+    if (extensions::v8_helpers::GetProperty(
+            v8_context, options, "compress", &value) && value->IsBoolean()) {
+      compress = value.As<v8::Boolean>()->Value();
+    }
+    ++next_arg;
+  }
+
   std::unique_ptr<v8::Global<v8::Function>> callback;
-  if (args.Length() > 2 && args[2]->IsFunction()) {
-    callback.reset(
-        new v8::Global<v8::Function>(isolate, args[2].As<v8::Function>()));
+  if (args.Length() > next_arg && args[next_arg]->IsFunction()) {
+    callback.reset(new v8::Global<v8::Function>(
+        isolate, args[next_arg].As<v8::Function>()));
   }
 
-  auto task_runner = GetTaskRunnerForFile(path,
-      BrowserThread::GetBlockingPool());
-  base::ImportantFileWriter writer(path, task_runner);
+  std::unique_ptr<Writer>& writer = writers_[path];
+  if (!writer)
+    writer.reset(new Writer(this, path));
+  writer->Write(data, compress, base::TimeDelta::FromMilliseconds(delay_ms),
+                std::move(callback));
+}
 
-  writer.RegisterOnNextWriteCallbacks(
-      base::Closure(),
-      base::Bind(
-        &PostWriteCallback,
-        base::Bind(&FileBindings::RunCallback, AsWeakPtr(),
-            base::Passed(&callback)),
-        base::SequencedTaskRunnerHandle::Get()));
+void FileBindings::Flush(const v8::FunctionCallbackInfo<v8::Value>& args) {
+  FlushAll();
+}
 
-  writer.WriteNow(base::MakeUnique<std::string>(data));
+void FileBindings::FlushAll() {
+  for (const auto& it : writers_)
+    it.second->Flush();
 }
 
 scoped_refptr<base::SequencedTaskRunner> FileBindings::GetTaskRunnerForFile(
@@ -123,6 +244,27 @@ scoped_refptr<base::SequencedTaskRunner> FileBindings::GetTaskRunnerForFile(
       base::SequencedWorkerPool::BLOCK_SHUTDOWN);
 }
 
+void FileBindings::OnWriteDone(
+    const base::FilePath& path,
+    std::vector<std::unique_ptr<v8::Global<v8::Function>>> callbacks,
+    bool success) {
+  // Writers are dropped once idle, a path is seldom written only once.
+  auto it = writers_.find(path);
+  if (it != writers_.end()) {
+    it->second->OnWriteDone();
+    if (it->second->IsIdle())
+      writers_.erase(it);
+  }
+  RunCallbacks(std::move(callbacks), success);
+}
+
+void FileBindings::RunCallbacks(
+    std::vector<std::unique_ptr<v8::Global<v8::Function>>> callbacks,
+    bool success) {
+  for (auto& callback : callbacks)
+    RunCallback(std::move(callback), success);
+}
+
 void FileBindings::RunCallback(
     std::unique_ptr<v8::Global<v8::Function>> callback, bool success) {
   if (!context()->is_valid() || !callback.get() || callback->IsEmpty())
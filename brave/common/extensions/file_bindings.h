@@ -5,16 +5,18 @@
 #ifndef BRAVE_COMMON_EXTENSIONS_FILE_BINDINGS_H_
 #define BRAVE_COMMON_EXTENSIONS_FILE_BINDINGS_H_
 
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "extensions/renderer/object_backed_native_handler.h"
 #include "v8/include/v8.h"
 
 namespace base {
-class FilePath;
 class SequencedTaskRunner;
 class SequencedWorkerPool;
 }
@@ -30,14 +32,32 @@ class FileBindings : public extensions::ObjectBackedNativeHandler,
   static v8::Local<v8::Object> API(extensions::ScriptContext* context);
 
  private:
+  class Writer;
+
+  // writeImportant(path, data[, options][, callback]) writes |data|
+  // atomically. With options.delay, the writes of a path made within that
+  // many milliseconds are coalesced into one write of the latest data.
   void WriteImportantFile(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Starts the pending writes right away, e.g. before quitting.
+  void Flush(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void FlushAll();
+
+  void OnWriteDone(
+      const base::FilePath& path,
+      std::vector<std::unique_ptr<v8::Global<v8::Function>>> callbacks,
+      bool success);
   void RunCallback(
       std::unique_ptr<v8::Global<v8::Function>> holder, bool success);
+  void RunCallbacks(
+      std::vector<std::unique_ptr<v8::Global<v8::Function>>> holders,
+      bool success);
 
   static scoped_refptr<base::SequencedTaskRunner> GetTaskRunnerForFile(
       const base::FilePath& filename,
       base::SequencedWorkerPool* worker_pool);
 
+  std::map<base::FilePath, std::unique_ptr<Writer>> writers_;
+
   DISALLOW_COPY_AND_ASSIGN(FileBindings);
 };
 
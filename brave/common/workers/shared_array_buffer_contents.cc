@@ -0,0 +1,135 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/shared_array_buffer_contents.h"
+
+#include <map>
+#include <set>
+
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
+#include "gin/array_buffer.h"
+
+namespace brave {
+
+namespace {
+
+// A SharedArrayBuffer of an isolate and the reference it holds.
+struct Holder {
+  v8::Isolate* isolate;
+  v8::Global<v8::SharedArrayBuffer> buffer;
+  scoped_refptr<SharedArrayBufferContents> contents;
+};
+
+struct Registry {
+  base::Lock lock;
+  // The contents by address, to find them when a buffer is posted again.
+  std::map<void*, SharedArrayBufferContents*> contents;
+  std::map<v8::Isolate*, std::set<Holder*>> holders;
+};
+
+base::LazyInstance<Registry>::Leaky g_registry = LAZY_INSTANCE_INITIALIZER;
+
+void OnBufferCollected(const v8::WeakCallbackInfo<Holder>& data) {
+  Holder* holder = data.GetParameter();
+  holder->buffer.Reset();
+  {
+    base::AutoLock auto_lock(g_registry.Get().lock);
+    g_registry.Get().holders[holder->isolate].erase(holder);
+  }
+  // Deleted out of the lock, the contents may go with it.
+  delete holder;
+}
+
+}  // namespace
+
+// static
+scoped_refptr<SharedArrayBufferContents>
+SharedArrayBufferContents::FromSharedArrayBuffer(
+    v8::Isolate* isolate,
+    v8::Local<v8::SharedArrayBuffer> buffer) {
+  if (buffer->ByteLength() == 0)
+    return make_scoped_refptr(new SharedArrayBufferContents(nullptr, 0));
+
+  if (buffer->IsExternal()) {
+    // Posted before, |buffer| itself keeps the contents alive.
+    Registry& registry = g_registry.Get();
+    base::AutoLock auto_lock(registry.lock);
+    auto it = registry.contents.find(buffer->GetContents().Data());
+    if (it == registry.contents.end())
+      return nullptr;
+    return make_scoped_refptr(it->second);
+  }
+
+  v8::SharedArrayBuffer::Contents contents = buffer->Externalize();
+  scoped_refptr<SharedArrayBufferContents> result(
+      new SharedArrayBufferContents(contents.Data(), contents.ByteLength()));
+  result->Track(isolate, buffer);
+  return result;
+}
+
+// static
+void SharedArrayBufferContents::ReleaseIsolate(v8::Isolate* isolate) {
+  std::set<Holder*> holders;
+  {
+    Registry& registry = g_registry.Get();
+    base::AutoLock auto_lock(registry.lock);
+    auto it = registry.holders.find(isolate);
+    if (it == registry.holders.end())
+      return;
+    holders.swap(it->second);
+    registry.holders.erase(it);
+  }
+
+  for (Holder* holder : holders) {
+    holder->buffer.Reset();
+    delete holder;
+  }
+}
+
+SharedArrayBufferContents::SharedArrayBufferContents(void* data,
+                                                     size_t length)
+    : data_(data),
+      length_(length) {
+  if (!data_)
+    return;
+
+  base::AutoLock auto_lock(g_registry.Get().lock);
+  g_registry.Get().contents[data_] = this;
+}
+
+SharedArrayBufferContents::~SharedArrayBufferContents() {
+  if (!data_)
+    return;
+
+  {
+    base::AutoLock auto_lock(g_registry.Get().lock);
+    g_registry.Get().contents.erase(data_);
+  }
+  gin::ArrayBufferAllocator::SharedInstance()->Free(data_, length_);
+}
+
+v8::Local<v8::SharedArrayBuffer>
+SharedArrayBufferContents::ToSharedArrayBuffer(v8::Isolate* isolate) {
+  v8::Local<v8::SharedArrayBuffer> buffer = v8::SharedArrayBuffer::New(
+      isolate, data_, length_, v8::ArrayBufferCreationMode::kExternalized);
+  if (data_)
+    Track(isolate, buffer);
+  return buffer;
+}
+
+void SharedArrayBufferContents::Track(v8::Isolate* isolate,
+                                      v8::Local<v8::SharedArrayBuffer> buffer) {
+  Holder* holder = new Holder;
+  holder->isolate = isolate;
+  holder->buffer.Reset(isolate, buffer);
+  holder->contents = this;
+  holder->buffer.SetWeak(holder, &OnBufferCollected,
+                         v8::WeakCallbackType::kParameter);
+
+  base::AutoLock auto_lock(g_registry.Get().lock);
+  g_registry.Get().holders[isolate].insert(holder);
+}
+
+}  // namespace brave
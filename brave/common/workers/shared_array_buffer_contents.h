@@ -0,0 +1,51 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_SHARED_ARRAY_BUFFER_CONTENTS_H_
+#define BRAVE_COMMON_WORKERS_SHARED_ARRAY_BUFFER_CONTENTS_H_
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+// The memory of a SharedArrayBuffer posted between the isolates of the main
+// process and the workers. Every SharedArrayBuffer backed by it holds a
+// reference, so that it is freed once the last of them has been collected
+// or its isolate has been disposed.
+class SharedArrayBufferContents
+    : public base::RefCountedThreadSafe<SharedArrayBufferContents> {
+ public:
+  // Returns the contents of |buffer|, taking them over from V8 the first
+  // time it is posted. Returns null if they are owned by someone else.
+  static scoped_refptr<SharedArrayBufferContents> FromSharedArrayBuffer(
+      v8::Isolate* isolate,
+      v8::Local<v8::SharedArrayBuffer> buffer);
+
+  // Drops the references of the SharedArrayBuffers of |isolate|, which is
+  // about to be disposed without collecting them.
+  static void ReleaseIsolate(v8::Isolate* isolate);
+
+  // Returns a new SharedArrayBuffer of |isolate| backed by the contents.
+  v8::Local<v8::SharedArrayBuffer> ToSharedArrayBuffer(v8::Isolate* isolate);
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedArrayBufferContents>;
+
+  SharedArrayBufferContents(void* data, size_t length);
+  ~SharedArrayBufferContents();
+
+  // Keeps the contents alive as long as |buffer| is.
+  void Track(v8::Isolate* isolate, v8::Local<v8::SharedArrayBuffer> buffer);
+
+  void* data_;
+  size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedArrayBufferContents);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_SHARED_ARRAY_BUFFER_CONTENTS_H_
@@ -9,6 +9,7 @@
 #include "base/lazy_instance.h"
 #include "base/run_loop.h"
 #include "base/threading/thread_local.h"
+#include "brave/common/workers/shared_array_buffer_contents.h"
 #include "brave/common/workers/worker_bindings.h"
 #include "content/child/worker_thread_registry.h"
 #include "content/public/browser/browser_thread.h"
@@ -106,6 +107,8 @@ void V8WorkerThread::CleanUp() {
   content::WorkerThreadRegistry::Instance()->WillStopCurrentWorkerThread();
   memory_pressure_listener_.reset();
   env()->OnMessageLoopDestroying();
+  // The isolate is disposed without collecting its SharedArrayBuffers.
+  SharedArrayBufferContents::ReleaseIsolate(env()->isolate());
   js_env_.reset();
   V8WorkerThread::Shutdown();
 }
@@ -2,17 +2,22 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "brave/common/workers/worker_bindings.h"
 
 #include "atom/browser/api/atom_api_app.h"
+#include "brave/common/workers/shared_array_buffer_contents.h"
 #include "brave/common/workers/v8_worker_thread.h"
 #include "content/child/worker_thread_registry.h"
 #include "content/public/browser/browser_thread.h"
 #include "extensions/renderer/script_context.h"
 #include "extensions/renderer/v8_helpers.h"
+#include "gin/array_buffer.h"
 #include "v8/include/v8.h"
 
 using content::BrowserThread;
@@ -21,8 +26,155 @@ using extensions::v8_helpers::IsTrue;
 
 namespace brave {
 
+// A message serialized by v8::ValueSerializer, with the contents of the
+// ArrayBuffers it transfers. Whatever the receiver did not take is freed.
+struct SerializedWorkerMessage {
+  SerializedWorkerMessage() : buffer(nullptr, 0) {}
+  ~SerializedWorkerMessage() {
+    free(buffer.first);
+    for (const auto& contents : array_buffers) {
+      gin::ArrayBufferAllocator::SharedInstance()->Free(contents.first,
+                                                        contents.second);
+    }
+  }
+
+  std::pair<uint8_t*, size_t> buffer;
+  std::vector<std::pair<void*, size_t>> array_buffers;
+  std::vector<scoped_refptr<SharedArrayBufferContents>> shared_array_buffers;
+};
+
 namespace {
 
+// Shares the memory of the SharedArrayBuffers in a message, instead of
+// failing to serialize them.
+class SerializerDelegate : public v8::ValueSerializer::Delegate {
+ public:
+  SerializerDelegate(v8::Isolate* isolate, SerializedWorkerMessage* message)
+      : isolate_(isolate),
+        message_(message) {
+  }
+
+  void ThrowDataCloneError(v8::Local<v8::String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
+
+  v8::Maybe<uint32_t> GetSharedArrayBufferId(
+      v8::Isolate* isolate,
+      v8::Local<v8::SharedArrayBuffer> buffer) override {
+    for (size_t i = 0; i < shared_array_buffers_.size(); ++i) {
+      if (shared_array_buffers_[i] == buffer)
+        return v8::Just<uint32_t>(i);
+    }
+
+    scoped_refptr<SharedArrayBufferContents> contents =
+        SharedArrayBufferContents::FromSharedArrayBuffer(isolate, buffer);
+    if (!contents) {
+      ThrowDataCloneError(v8::String::NewFromUtf8(isolate,
+          "A SharedArrayBuffer owned by someone else can't be shared"));
+      return v8::Nothing<uint32_t>();
+    }
+    shared_array_buffers_.push_back(buffer);
+    message_->shared_array_buffers.push_back(contents);
+    return v8::Just<uint32_t>(shared_array_buffers_.size() - 1);
+  }
+
+ private:
+  v8::Isolate* isolate_;
+  SerializedWorkerMessage* message_;
+  std::vector<v8::Local<v8::SharedArrayBuffer>> shared_array_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(SerializerDelegate);
+};
+
+// Serializes |value|, detaching the ArrayBuffers in |transfer_list| and
+// taking their contents instead of copying them. All isolates share the gin
+// allocator, so the receiver can own the contents as they are.
+std::unique_ptr<SerializedWorkerMessage> Serialize(
+    v8::Isolate* isolate,
+    v8::Local<v8::Context> context,
+    v8::Local<v8::Value> value,
+    v8::Local<v8::Value> transfer_list,
+    std::string* error) {
+  std::unique_ptr<SerializedWorkerMessage> message(
+      new SerializedWorkerMessage);
+  SerializerDelegate delegate(isolate, message.get());
+  v8::ValueSerializer serializer(isolate, &delegate);
+  std::vector<v8::Local<v8::ArrayBuffer>> array_buffers;
+  if (!transfer_list.IsEmpty() && !transfer_list->IsUndefined()) {
+    if (!transfer_list->IsArray()) {
+      *error = "`transferList` must be an array";
+      return nullptr;
+    }
+    v8::Local<v8::Array> list = transfer_list.As<v8::Array>();
+    for (uint32_t i = 0; i < list->Length(); ++i) {
+      v8::Local<v8::Value> item;
+      if (!list->Get(context, i).ToLocal(&item) || !item->IsArrayBuffer()) {
+        *error = "`transferList` can only contain ArrayBuffers";
+        return nullptr;
+      }
+      v8::Local<v8::ArrayBuffer> array_buffer = item.As<v8::ArrayBuffer>();
+      if (!array_buffer->IsNeuterable() ||
+          std::find(array_buffers.begin(), array_buffers.end(),
+                    array_buffer) != array_buffers.end()) {
+        *error = "An ArrayBuffer in `transferList` can't be transferred";
+        return nullptr;
+      }
+      serializer.TransferArrayBuffer(array_buffers.size(), array_buffer);
+      array_buffers.push_back(array_buffer);
+    }
+  }
+
+  serializer.WriteHeader();
+  if (!serializer.WriteValue(context, value).FromMaybe(false)) {
+    *error = "`postMessage` could not serialize message";
+    return nullptr;
+  }
+
+  message->buffer = serializer.Release();
+  // The buffers are only detached once the message is complete.
+  for (const auto& array_buffer : array_buffers) {
+    if (array_buffer->IsExternal()) {
+      // The contents belong to someone else, they have to be copied.
+      v8::ArrayBuffer::Contents contents = array_buffer->GetContents();
+      void* data = gin::ArrayBufferAllocator::SharedInstance()->
+          AllocateUninitialized(contents.ByteLength());
+      memcpy(data, contents.Data(), contents.ByteLength());
+      message->array_buffers.push_back(
+          std::make_pair(data, contents.ByteLength()));
+    } else {
+      v8::ArrayBuffer::Contents contents = array_buffer->Externalize();
+      message->array_buffers.push_back(
+          std::make_pair(contents.Data(), contents.ByteLength()));
+    }
+    array_buffer->Neuter();
+  }
+  return message;
+}
+
+v8::MaybeLocal<v8::Value> Deserialize(v8::Isolate* isolate,
+                                      v8::Local<v8::Context> context,
+                                      SerializedWorkerMessage* message) {
+  v8::ValueDeserializer deserializer(
+      isolate, message->buffer.first, message->buffer.second);
+  deserializer.SetSupportsLegacyWireFormat(true);
+  // The new ArrayBuffers own the transferred contents.
+  for (size_t i = 0; i < message->array_buffers.size(); ++i) {
+    deserializer.TransferArrayBuffer(i, v8::ArrayBuffer::New(
+        isolate, message->array_buffers[i].first,
+        message->array_buffers[i].second,
+        v8::ArrayBufferCreationMode::kInternalized));
+  }
+  message->array_buffers.clear();
+  for (size_t i = 0; i < message->shared_array_buffers.size(); ++i) {
+    deserializer.TransferSharedArrayBuffer(
+        i, message->shared_array_buffers[i]->ToSharedArrayBuffer(isolate));
+  }
+
+  if (!deserializer.ReadHeader(context).FromMaybe(false))
+    return v8::MaybeLocal<v8::Value>();
+  return deserializer.ReadValue(context);
+}
+
 bool SetReadOnlyProperty(v8::Local<v8::Context> context,
                         v8::Local<v8::Object> object,
                         v8::Local<v8::String> key,
@@ -31,30 +183,26 @@ bool SetReadOnlyProperty(v8::Local<v8::Context> context,
       static_cast<v8::PropertyAttribute>(v8::ReadOnly)));
 }
 
-void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
+void OnMessageInternal(std::unique_ptr<SerializedWorkerMessage> message) {
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
 
-  v8::ValueDeserializer deserializer(
-      isolate, buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(context).FromMaybe(false)) {
-    v8::Local<v8::Value> message =
-        deserializer.ReadValue(context).ToLocalChecked();
-    v8::Local<v8::Object> global = context->Global();
-    v8::Local<v8::Value> onmessage =
-        global->Get(context, v8::String::NewFromUtf8(isolate, "onmessage",
-                                                v8::NewStringType::kNormal)
-                                 .ToLocalChecked()).ToLocalChecked();
-    if (onmessage->IsFunction()) {
-      v8::Local<v8::Function> onmessage_fun =
-          v8::Local<v8::Function>::Cast(onmessage);
-
-      v8::Local<v8::Value> argv[] = {message};
-      (void)onmessage_fun->Call(context, global, 1, argv);
-    }
+  v8::Local<v8::Value> value;
+  if (!Deserialize(isolate, context, message.get()).ToLocal(&value))
+    return;
+
+  v8::Local<v8::Object> global = context->Global();
+  v8::Local<v8::Value> onmessage =
+      global->Get(context, v8::String::NewFromUtf8(isolate, "onmessage",
+                                              v8::NewStringType::kNormal)
+                               .ToLocalChecked()).ToLocalChecked();
+  if (onmessage->IsFunction()) {
+    v8::Local<v8::Function> onmessage_fun =
+        v8::Local<v8::Function>::Cast(onmessage);
+
+    v8::Local<v8::Value> argv[] = {value};
+    (void)onmessage_fun->Call(context, global, 1, argv);
   }
-  free(buf.first);
 }
 
 }  // namespace
@@ -180,20 +328,18 @@ void WorkerBindings::Close(
 }
 
 void WorkerBindings::PostMessageOnUIThread(
-    const std::pair<uint8_t*, size_t>& buf) {
-  v8::ValueDeserializer deserializer(
-      worker_->app()->isolate(), buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(
-      worker_->app()->isolate()->GetCurrentContext()).FromMaybe(false)) {
-    v8::Local<v8::Value> val = deserializer.ReadValue(
-        worker_->app()->isolate()->GetCurrentContext()).ToLocalChecked();
+    std::unique_ptr<SerializedWorkerMessage> message) {
+  v8::Isolate* isolate = worker_->app()->isolate();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> val;
+  if (Deserialize(isolate, isolate->GetCurrentContext(),
+                  message.get()).ToLocal(&val)) {
     worker_->app()->Emit("worker-post-message", worker_->GetThreadId(), val);
   } else {
     worker_->app()->Emit("worker-onerror", worker_->GetThreadId(),
         "`postMessage` could not deserialize message buffer");
   }
-  free(buf.first);
 }
 
 void WorkerBindings::PostMessage(
@@ -204,46 +350,39 @@ void WorkerBindings::PostMessage(
     return;
   }
 
-  if (args.Length() > 1) {
+  std::string error;
+  std::unique_ptr<SerializedWorkerMessage> message = Serialize(
+      context()->isolate(), context()->v8_context(), args[0], args[1],
+      &error);
+  if (!message) {
     context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`transferList` is not supported yet"));
+        context()->isolate(), error.c_str()));
     return;
   }
 
-  v8::ValueSerializer serializer(context()->isolate());
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      context()->v8_context(), args[0]).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
-
-    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-        base::Bind(&WorkerBindings::PostMessageOnUIThread,
-                    weak_ptr_factory_.GetWeakPtr(),
-                    std::move(buffer)));
-  } else {
-    context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`postMessage` could not serialize message"));
-  }
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&WorkerBindings::PostMessageOnUIThread,
+                  weak_ptr_factory_.GetWeakPtr(),
+                  base::Passed(&message)));
 }
 
 // static
 bool WorkerBindings::OnMessage(v8::Isolate* isolate,
                                 base::PlatformThreadId thread_id,
-                                v8::Local<v8::Value> message) {
-  v8::ValueSerializer serializer(isolate);
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      isolate->GetCurrentContext(), message).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
-
-    base::TaskRunner* task_runner =
-        content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
-    task_runner->PostTask(FROM_HERE,
-        base::Bind(&OnMessageInternal,
-        std::move(buffer)));
-    return true;
-  }
-  return false;
+                                v8::Local<v8::Value> message,
+                                v8::Local<v8::Value> transfer_list,
+                                std::string* error) {
+  std::unique_ptr<SerializedWorkerMessage> serialized = Serialize(
+      isolate, isolate->GetCurrentContext(), message, transfer_list, error);
+  if (!serialized)
+    return false;
+
+  base::TaskRunner* task_runner =
+      content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
+  task_runner->PostTask(FROM_HERE,
+      base::Bind(&OnMessageInternal,
+      base::Passed(&serialized)));
+  return true;
 }
 
 }  // namespace brave
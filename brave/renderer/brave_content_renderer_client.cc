@@ -16,6 +16,7 @@
 #include "chrome/renderer/pepper/pepper_helper.h"
 #include "chrome/renderer/plugins/non_loadable_plugin_placeholder.h"
 #include "chrome/renderer/plugins/plugin_uma.h"
+#include "chrome/renderer/prerender/prerender_dispatcher.h"
 #include "content/public/common/content_constants.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_thread.h"
@@ -99,6 +100,11 @@ void BraveContentRendererClient::RenderThreadStarted() {
   prescient_networking_dispatcher_.reset(
       new network_hints::PrescientNetworkingDispatcher());
 
+  // Forwards <link rel=prerender> hints to the browser, which prefetches them.
+  // <link rel=prefetch> hints are picked up from their requests instead.
+  prerender_dispatcher_.reset(new prerender::PrerenderDispatcher());
+  thread->AddObserver(prerender_dispatcher_.get());
+
   for (auto& origin : GetSecureOriginWhitelist()) {
     WebSecurityPolicy::AddOriginTrustworthyWhiteList(
         WebSecurityOrigin::Create(origin));
@@ -31,6 +31,10 @@ namespace content {
 class RenderFrame;
 }
 
+namespace prerender {
+class PrerenderDispatcher;
+}
+
 class SpellCheck;
 
 namespace brave {
@@ -63,6 +67,7 @@ class BraveContentRendererClient : public ChromeContentRendererClient {
 
   std::unique_ptr<network_hints::PrescientNetworkingDispatcher>
       prescient_networking_dispatcher_;
+  std::unique_ptr<prerender::PrerenderDispatcher> prerender_dispatcher_;
 
   DISALLOW_COPY_AND_ASSIGN(BraveContentRendererClient);
 };
@@ -9,6 +9,7 @@ module.exports = app
 const electron = require('electron')
 const {deprecate, Menu} = electron
 const {EventEmitter} = require('events')
+const os = require('os')
 
 Object.setPrototypeOf(App.prototype, EventEmitter.prototype)
 
@@ -71,9 +72,9 @@ Worker.prototype.start = function (cb) {
   this.id = app._startWorker(this.module_name)
 }
 
-Worker.prototype.postMessage = function (message) {
+Worker.prototype.postMessage = function (message, transferList) {
   const evt = {data: message}
-  app._postMessage(this.id, evt)
+  app._postMessage(this.id, evt, transferList)
 }
 
 Worker.prototype.terminate = function () {
@@ -95,34 +96,204 @@ app.createWorker = function (module_name) {
 
   // It is always safe to call the worker methods because
   // WorkerThreadRegistry will return a dummy task runner
-  app.on('worker-start', (e, worker_id) => {
-    if (worker.id === worker_id) {
-      worker.emit('start', {})
+  const listeners = {
+    'worker-start': (e, worker_id) => {
+      if (worker.id === worker_id) {
+        worker.emit('start', {})
+      }
+    },
+    'worker-stop': (e, worker_id) => {
+      if (worker.id === worker_id) {
+        // The worker is done with, so are its listeners.
+        for (const name in listeners) {
+          app.removeListener(name, listeners[name])
+        }
+        worker.emit('stop', {})
+      }
+    },
+    'worker-post-message': (e, worker_id, message) => {
+      if (worker.id === worker_id) {
+        const event = {data: message}
+        worker.emit('message', event)
+        worker.onmessage && worker.onmessage(event)
+      }
+    },
+    'worker-onerror': (e, worker_id, message, stack) => {
+      worker.lastError = message
+      if (worker.id === worker_id) {
+        worker.onerror && worker.onerror(message, stack)
+      }
+    },
+    'app-post-message': (e, message) => {
+      worker.postMessage(message)
     }
+  }
+  for (const name in listeners) {
+    app.on(name, listeners[name])
+  }
+
+  return worker
+}
+
+// A pool of identical workers sharing one queue of tasks. Each task is posted
+// to an idle worker, and the next message that worker posts back is the
+// result of the task, so any worker module that replies once per message can
+// be pooled.
+function WorkerPool (module_name, options = {}) {
+  this.module_name = module_name
+  this.size = options.size || os.cpus().length
+  this.workers = []
+  this.idle = []
+  this.queue = []
+  this.running = new Map()
+  this.nextTaskId = 0
+  this.terminated = false
+  for (let i = 0; i < this.size; i++) {
+    this._addWorker()
+  }
+}
+
+Object.setPrototypeOf(WorkerPool.prototype, EventEmitter.prototype)
+
+WorkerPool.prototype._addWorker = function () {
+  const worker = app.createWorker(this.module_name)
+  worker.task = null
+  worker.started = false
+  worker.removed = false
+  worker.on('message', (event) => {
+    const task = worker.task
+    if (!task || worker.removed) return
+    this._release(worker)
+    task.callback && task.callback(null, event.data)
   })
-  app.on('worker-stop', (e, worker_id) => {
-    if (worker.id === worker_id) {
-      worker.emit('stop', {})
+  worker.onerror = (message, stack) => {
+    if (worker.removed) return
+    const task = worker.task
+    if (!task) {
+      if (this.listenerCount('error') > 0) this.emit('error', message, stack)
+      return
     }
-  })
-  app.on('worker-post-message', (e, worker_id, message) => {
-    if (worker.id === worker_id) {
-      const event = {data: message}
-      worker.emit('message', event)
-      worker.onmessage && worker.onmessage(event)
+    this._release(worker)
+    task.callback && task.callback(new Error(message))
+  }
+  worker.on('stop', () => {
+    if (worker.removed) return
+    this._removeWorker(worker)
+    // Keep the pool at its size when a worker stops, unless it never started
+    // and would fail again.
+    if (worker.started && !this.terminated) this._addWorker()
+    if (this.workers.length === 0) {
+      this._failQueue('No worker of the pool is running')
     }
   })
-  app.on('worker-onerror', (e, worker_id, message, stack) => {
-    worker.lastError = message
-    if (worker.id === worker_id) {
-      worker.onerror && worker.onerror(message, stack)
-    }
+  this.workers.push(worker)
+  worker.start(() => {
+    worker.started = true
+    this.idle.push(worker)
+    this._dispatch()
   })
-  app.on('app-post-message', (e, message) => {
-    worker.postMessage(message)
+}
+
+WorkerPool.prototype._removeWorker = function (worker) {
+  worker.removed = true
+  this.workers = this.workers.filter((w) => w !== worker)
+  this.idle = this.idle.filter((w) => w !== worker)
+  const task = worker.task
+  worker.task = null
+  if (task) {
+    this.running.delete(task.id)
+    task.callback && task.callback(new Error('Worker stopped'))
+  }
+}
+
+WorkerPool.prototype._failQueue = function (message) {
+  const queue = this.queue
+  this.queue = []
+  for (const task of queue) {
+    task.callback && task.callback(new Error(message))
+  }
+}
+
+WorkerPool.prototype._release = function (worker) {
+  this.running.delete(worker.task.id)
+  worker.task = null
+  this.idle.push(worker)
+  this._dispatch()
+}
+
+WorkerPool.prototype._dispatch = function () {
+  while (this.idle.length > 0 && this.queue.length > 0) {
+    const worker = this.idle.shift()
+    const task = this.queue.shift()
+    worker.task = task
+    this.running.set(task.id, worker)
+    worker.postMessage(task.data, task.transferList)
+  }
+}
+
+// Queues |data| for the next idle worker and returns the id of the task.
+// Tasks with a higher |options.priority| run first, in the order they were
+// queued for the same priority. The ArrayBuffers in |options.transferList|
+// are handed to the worker once the task starts.
+WorkerPool.prototype.run = function (data, options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+  if (this.terminated) throw new Error('The worker pool has been terminated')
+  if (this.workers.length === 0) {
+    throw new Error('No worker of the pool is running')
+  }
+
+  const task = {
+    id: ++this.nextTaskId,
+    priority: (options && options.priority) || 0,
+    transferList: options && options.transferList,
+    data,
+    callback
+  }
+  let index = this.queue.findIndex((queued) => {
+    return queued.priority < task.priority
   })
+  if (index === -1) index = this.queue.length
+  this.queue.splice(index, 0, task)
+  this._dispatch()
+  return task.id
+}
 
-  return worker
+// Removes a queued task, or stops the worker running it. Returns whether the
+// task was found, its callback is not called.
+WorkerPool.prototype.cancel = function (taskId) {
+  const index = this.queue.findIndex((task) => task.id === taskId)
+  if (index !== -1) {
+    this.queue.splice(index, 1)
+    return true
+  }
+
+  const worker = this.running.get(taskId)
+  if (!worker) return false
+  this.running.delete(taskId)
+  worker.task = null
+  // A worker can't be interrupted, it is replaced once it has stopped.
+  this.idle = this.idle.filter((w) => w !== worker)
+  worker.terminate()
+  return true
+}
+
+WorkerPool.prototype.getPendingTaskCount = function () {
+  return this.queue.length + this.running.size
+}
+
+WorkerPool.prototype.terminate = function () {
+  this.terminated = true
+  this._failQueue('The worker pool has been terminated')
+  for (const worker of this.workers) {
+    worker.terminate()
+  }
+}
+
+app.createWorkerPool = function (module_name, options) {
+  return new WorkerPool(module_name, options)
 }
 
 app.allowNTLMCredentialsForAllDomains = function (allow) {
@@ -105,6 +105,45 @@ WebContents.prototype.sendToAll = function (channel, ...args) {
   if (channel == null) throw new Error('Missing required channel argument')
   return this._send(true, channel, args)
 }
+WebContents.prototype.sendStructured = function (channel, ...args) {
+  if (channel == null) throw new Error('Missing required channel argument')
+  return this._sendStructured(false, channel, args)
+}
+WebContents.prototype.sendStructuredToAll = function (channel, ...args) {
+  if (channel == null) throw new Error('Missing required channel argument')
+  return this._sendStructured(true, channel, args)
+}
+
+// The native side only emits the events that have listeners, so that it
+// doesn't build the arguments of the others.
+const onNewListener = function (name) {
+  if (typeof name === 'string' && !this.isDestroyed()) {
+    this._setListening(name, true)
+  }
+}
+const onRemoveListener = function (name) {
+  if (typeof name === 'string' && !this.isDestroyed()) {
+    this._setListening(name, this.listenerCount(name) > 0)
+  }
+}
+const trackListeners = function (webContents) {
+  if (webContents.isDestroyed()) return
+  if (!webContents.listeners('newListener').includes(onNewListener)) {
+    webContents.on('newListener', onNewListener)
+  }
+  if (!webContents.listeners('removeListener').includes(onRemoveListener)) {
+    webContents.on('removeListener', onRemoveListener)
+  }
+  webContents._setListeners(webContents.eventNames().filter((name) => {
+    return typeof name === 'string'
+  }))
+}
+
+WebContents.prototype.removeAllListeners = function (...args) {
+  const result = EventEmitter.prototype.removeAllListeners.apply(this, args)
+  trackListeners(this)
+  return result
+}
 
 WebContents.prototype.clone = function(...args) {
   if (args.length === 0) {
@@ -184,7 +223,12 @@ WebContents.prototype._init = function () {
   this.on('ipc-message-sync', function (event, [channel, ...args]) {
     Object.defineProperty(event, 'returnValue', {
       set: function (value) {
-        return event.sendReply(JSON.stringify(value))
+        try {
+          return event.sendReply(value)
+        } catch (error) {
+          // Values that can't be cloned are sent the way JSON would.
+          return event.sendReply(JSON.parse(JSON.stringify(value)))
+        }
       },
       get: function () {}
     })
@@ -207,6 +251,8 @@ WebContents.prototype._init = function () {
     guestViewManager.registerGuest(event.sender, embedder)
   })
 
+  trackListeners(this)
+
   app.emit('web-contents-created', {}, this)
 }
 
@@ -1,101 +1,34 @@
 'use strict'
 
-const v8Util = process.atomBinding('v8_util')
+// The registry itself lives in native code, so that renderers can release
+// their references without going through JavaScript.
+const binding = process.atomBinding('objects_registry')
 
-class ObjectsRegistry {
-  constructor () {
-    this.nextId = 0
-
-    // Stores all objects by ref-counting.
-    // (id) => {object, count}
-    this.storage = {}
-
-    // Stores the IDs of objects referenced by WebContents.
-    // (webContentsId) => [id]
-    this.owners = {}
-  }
-
-  // Register a new object and return its assigned ID. If the object is already
-  // registered then the already assigned ID would be returned.
+module.exports = {
+  // Register an object and return its ID, the same object always gets the
+  // same ID while it's referenced.
   add (webContents, obj) {
-    // Get or assign an ID to the object.
-    let id = this.saveToStorage(obj)
-
-    // Add object to the set of referenced objects.
-    let webContentsId = webContents.getId()
-    let owner = this.owners[webContentsId]
-    if (!owner) {
-      owner = this.owners[webContentsId] = new Set()
-      // Clear the storage when webContents is reloaded/navigated.
-      webContents.once('will-destroy', () => {
-        this.clear(webContentsId)
-      })
-    }
-    if (!owner.has(id)) {
-      owner.add(id)
-      // Increase reference count if not referenced before.
-      this.storage[id].count++
-    }
-    return id
-  }
+    return binding.add(webContents.getId(), obj)
+  },
 
   // Get an object according to its ID.
   get (id) {
-    return this.storage[id].object
-  }
-
-  // Dereference an object according to its ID.
-  remove (webContentsId, id) {
-    // don't let an owner remove itself
-    if (webContentsId === id)
-      return
+    return binding.get(id)
+  },
 
-    // Dereference from the storage.
-    this.dereference(id)
+  // Dereference an object according to its ID, |count| being the number of
+  // times the WebContents received it.
+  remove (webContentsId, id, count = 1) {
+    binding.remove(webContentsId, id, count)
+  },
 
-    // Also remove the reference in owner.
-    let owner = this.owners[webContentsId]
-    if (owner) {
-      owner.delete(id)
-    }
-  }
-
-  // Clear all references to objects refrenced by the WebContents.
+  // Clear all references to objects referenced by the WebContents.
   clear (webContentsId) {
-    let owner = this.owners[webContentsId]
-    if (!owner) return
-
-    for (let id of owner) this.dereference(id)
-
-    delete this.owners[webContentsId]
-  }
-
-  // Private: Saves the object into storage and assigns an ID for it.
-  saveToStorage (object) {
-    let id = v8Util.getHiddenValue(object, 'atomId')
-    if (!id) {
-      id = ++this.nextId
-      this.storage[id] = {
-        count: 0,
-        object: object
-      }
-      v8Util.setHiddenValue(object, 'atomId', id)
-    }
-    return id
-  }
+    binding.clear(webContentsId)
+  },
 
-  // Private: Dereference the object from store.
-  dereference (id) {
-    let pointer = this.storage[id]
-    if (pointer == null) {
-      return
-    }
-    pointer.count -= 1
-    if (pointer.count === 0) {
-      v8Util.deleteHiddenValue(pointer.object, 'atomId')
-      return delete this.storage[id]
-    }
+  // Get the number of objects referenced by the WebContents.
+  getCount (webContentsId) {
+    return binding.getCount(webContentsId)
   }
 }
-
-module.exports = new ObjectsRegistry()
@@ -18,6 +18,28 @@ const FUNCTION_PROPERTIES = [
 // id => Function
 let rendererFunctions = v8Util.createDoubleIDWeakMap()
 
+// Renderers cache the descriptions of prototypes and only ask for them again
+// when their version changes.
+// id => prototype
+const prototypes = v8Util.createIDWeakMap()
+// prototype => {id, version, signature}
+const prototypeVersions = new WeakMap()
+let nextPrototypeId = 0
+
+// Whether |value| arrives unchanged once serialized to JSON, as the messages
+// are, unlike undefined, NaN or Infinity.
+const isJSONSafe = function (value) {
+  switch (typeof value) {
+    case 'string':
+    case 'boolean':
+      return true
+    case 'number':
+      return isFinite(value)
+    default:
+      return value === null
+  }
+}
+
 // Return the description of object's members:
 let getObjectMembers = function (object) {
   let names = Object.getOwnPropertyNames(object)
@@ -37,19 +59,44 @@ let getObjectMembers = function (object) {
     } else {
       if (descriptor.set || descriptor.writable) member.writable = true
       member.type = 'get'
+
+      // Constants are sent along so that reading them needs no round trip.
+      if (!member.writable && !descriptor.configurable &&
+          hasProp.call(descriptor, 'value') && isJSONSafe(descriptor.value)) {
+        member.constant = true
+        member.value = descriptor.value
+      }
     }
     return member
   })
 }
 
-// Return the description of object's prototype.
+// Return the description of a prototype, with a reference to its own
+// prototype. The version changes whenever the members of the prototype or
+// of its prototype chain do.
+let describePrototype = function (proto) {
+  const members = getObjectMembers(proto)
+  const parent = getObjectPrototype(proto)
+  const signature = JSON.stringify([members, parent])
+
+  let entry = prototypeVersions.get(proto)
+  if (!entry) {
+    entry = {id: ++nextPrototypeId, version: 0, signature}
+    prototypeVersions.set(proto, entry)
+    prototypes.set(entry.id, proto)
+  } else if (entry.signature !== signature) {
+    entry.version++
+    entry.signature = signature
+  }
+  return {id: entry.id, version: entry.version, members, proto: parent}
+}
+
+// Return a reference to object's prototype.
 let getObjectPrototype = function (object) {
   let proto = Object.getPrototypeOf(object)
   if (proto === null || proto === Object.prototype) return null
-  return {
-    members: getObjectMembers(proto),
-    proto: getObjectPrototype(proto)
-  }
+  const {id, version} = describePrototype(proto)
+  return {id, version}
 }
 
 // Convert a real value into meta data.
@@ -346,15 +393,18 @@ ipcMain.on('ELECTRON_BROWSER_MEMBER_GET', function (event, id, name) {
   }
 })
 
-ipcMain.on('ELECTRON_BROWSER_DEREFERENCE', function (event, id) {
-  objectsRegistry.remove(event.sender.getId(), id)
+ipcMain.on('ELECTRON_BROWSER_PROTOTYPE', function (event, id) {
+  if (!prototypes.has(id)) {
+    event.returnValue = null
+    return
+  }
+  const {version, members, proto} = describePrototype(prototypes.get(id))
+  event.returnValue = {version, members, proto}
 })
 
-ipcMain.on('ELECTRON_BROWSER_SEND_TO', function (event, sendToAll, webContentsId, channel, ...args) {
-  let contents = webContents.fromId(webContentsId)
-  if (sendToAll) {
-    contents.sendToAll(channel, ...args)
-  } else {
-    contents.send(channel, ...args)
+// Operations without a result, queued by the renderer and sent together.
+ipcMain.on('ELECTRON_BROWSER_BATCH', function (event, operations) {
+  for (const [channel, ...args] of operations) {
+    ipcMain.emit(channel, event, ...args)
   }
 })
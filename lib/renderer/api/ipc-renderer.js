@@ -23,7 +23,7 @@ ipcRenderer.sendTo = function (webContentsId, channel, ...args) {
     throw new TypeError('First argument has to be webContentsId')
   }
 
-  ipcRenderer.send('ELECTRON_BROWSER_SEND_TO', false, webContentsId, channel, ...args)
+  binding.sendTo(false, webContentsId, channel, args)
 }
 
 ipcRenderer.sendToAll = function (webContentsId, channel, ...args) {
@@ -31,7 +31,7 @@ ipcRenderer.sendToAll = function (webContentsId, channel, ...args) {
     throw new TypeError('First argument has to be webContentsId')
   }
 
-  ipcRenderer.send('ELECTRON_BROWSER_SEND_TO', true, webContentsId, channel, ...args)
+  binding.sendTo(true, webContentsId, channel, args)
 }
 
 module.exports = ipcRenderer
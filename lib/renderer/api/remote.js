@@ -10,6 +10,32 @@ const callbacksRegistry = new CallbacksRegistry()
 
 const remoteObjectCache = v8Util.createIDWeakMap()
 
+// The descriptions of the prototypes of remote objects.
+// id => {version, members, proto}
+const prototypeCache = new Map()
+
+// Operations without a result are queued and sent together at the end of the
+// microtask instead of blocking the renderer one by one. ipcRenderer sends
+// them before any other message, so the browser still sees them in order.
+let pendingOperations = null
+
+const flushPendingOperations = function () {
+  if (pendingOperations === null) return
+  const operations = pendingOperations
+  pendingOperations = null
+  ipcRenderer.send('ELECTRON_BROWSER_BATCH', operations)
+}
+
+const queueOperation = function (...operation) {
+  if (pendingOperations === null) {
+    pendingOperations = []
+    Promise.resolve().then(flushPendingOperations)
+  }
+  pendingOperations.push(operation)
+}
+
+ipcRenderer.addBeforeSendHook(flushPendingOperations)
+
 // Convert the arguments object into an array of meta data.
 const wrapArgs = function (args, visited) {
   if (visited == null) {
@@ -126,6 +152,8 @@ const setObjectMembers = function (ref, object, metaId, members) {
         return value
       }
       descriptor.configurable = true
+    } else if (member.constant) {
+      descriptor.value = member.value
     } else if (member.type === 'get') {
       descriptor.get = function () {
         return metaToValue(ipcRenderer.sendSync('ELECTRON_BROWSER_MEMBER_GET', metaId, member.name))
@@ -134,7 +162,7 @@ const setObjectMembers = function (ref, object, metaId, members) {
       // Only set setter when it is writable.
       if (member.writable) {
         descriptor.set = function (value) {
-          ipcRenderer.sendSync('ELECTRON_BROWSER_MEMBER_SET', metaId, member.name, value)
+          queueOperation('ELECTRON_BROWSER_MEMBER_SET', metaId, member.name, value)
           return value
         }
       }
@@ -144,9 +172,23 @@ const setObjectMembers = function (ref, object, metaId, members) {
   }
 }
 
-// Populate object's prototype from descriptor.
+// Get the description of a prototype from the cache, or from the browser when
+// it isn't cached or has changed since.
+const getPrototypeDescriptor = function (prototypeRef) {
+  let descriptor = prototypeCache.get(prototypeRef.id)
+  if (descriptor === undefined || descriptor.version !== prototypeRef.version) {
+    descriptor = ipcRenderer.sendSync('ELECTRON_BROWSER_PROTOTYPE', prototypeRef.id)
+    if (descriptor === null) return null
+    prototypeCache.set(prototypeRef.id, descriptor)
+  }
+  return descriptor
+}
+
+// Populate object's prototype from its reference.
 // This matches |getObjectPrototype| in rpc-server.
-const setObjectPrototype = function (ref, object, metaId, descriptor) {
+const setObjectPrototype = function (ref, object, metaId, prototypeRef) {
+  if (prototypeRef === null) return
+  const descriptor = getPrototypeDescriptor(prototypeRef)
   if (descriptor === null) return
   let proto = {}
   setObjectMembers(ref, proto, metaId, descriptor.members)
@@ -218,7 +260,13 @@ const metaToValue = function (meta) {
     case 'exception':
       throw new Error(meta.message + '\n' + meta.stack)
     default:
-      if (remoteObjectCache.has(meta.id)) return remoteObjectCache.get(meta.id)
+      if (remoteObjectCache.has(meta.id)) {
+        ret = remoteObjectCache.get(meta.id)
+        // The browser counts every time it sends the object, release it as
+        // many times.
+        v8Util.setRemoteObjectFreer(ret, meta.id)
+        return ret
+      }
 
       if (meta.type === 'function') {
         // A shadow class to represent the remote function object.
@@ -329,9 +329,182 @@ describe('app module', function () {
     })
   })
 
+  describe('app.createWorkerPool(moduleName, options)', function () {
+    const moduleName = 'spec/fixtures/workers/pool_worker'
+    let pool = null
+
+    afterEach(function () {
+      if (pool) pool.terminate()
+      pool = null
+    })
+
+    it('delivers the result of a task', function (done) {
+      pool = app.createWorkerPool(moduleName, {size: 2})
+      pool.run({value: 'hello'}, function (error, result) {
+        assert.equal(error, null)
+        assert.equal(result, 'hello')
+        assert.equal(pool.getPendingTaskCount(), 0)
+        done()
+      })
+    })
+
+    it('runs the tasks with a higher priority first', function (done) {
+      pool = app.createWorkerPool(moduleName, {size: 1})
+      const results = []
+      const callback = function (error, result) {
+        assert.equal(error, null)
+        results.push(result)
+        if (results.length === 4) {
+          assert.deepEqual(results, ['first', 'high', 'normal', 'low'])
+          done()
+        }
+      }
+      // The others are queued while the worker is busy with the first one.
+      pool.run({value: 'first', wait: 500}, callback)
+      pool.run({value: 'low'}, {priority: -1}, callback)
+      pool.run({value: 'normal'}, callback)
+      pool.run({value: 'high'}, {priority: 1}, callback)
+    })
+
+    it('does not run a cancelled task', function (done) {
+      pool = app.createWorkerPool(moduleName, {size: 1})
+      pool.run({value: 'first', wait: 500})
+      const taskId = pool.run({value: 'cancelled'}, function () {
+        done(new Error('The cancelled task ran'))
+      })
+      assert.equal(pool.cancel(taskId), true)
+      assert.equal(pool.cancel(taskId), false)
+      pool.run({value: 'last'}, function (error, result) {
+        assert.equal(error, null)
+        assert.equal(result, 'last')
+        done()
+      })
+    })
+
+    it('replaces the worker of a cancelled running task', function (done) {
+      pool = app.createWorkerPool(moduleName, {size: 1})
+      const taskId = pool.run({value: 'cancelled', wait: 500}, function () {
+        done(new Error('The cancelled task ran'))
+      })
+      pool.run({value: 'last'}, function (error, result) {
+        assert.equal(error, null)
+        assert.equal(result, 'last')
+        done()
+      })
+      setTimeout(function () {
+        assert.equal(pool.cancel(taskId), true)
+      }, 100)
+    })
+
+    it('fails the queued tasks when no worker is running', function (done) {
+      pool = app.createWorkerPool('spec/fixtures/workers/missing', {size: 1})
+      pool.run({value: 'never'}, function (error) {
+        assert.ok(/No worker of the pool is running/.test(error.message))
+        assert.throws(function () {
+          pool.run({value: 'never'})
+        }, /No worker of the pool is running/)
+        done()
+      })
+    })
+
+    it('removes the app listeners of its workers once stopped', function (done) {
+      const count = app.listenerCount('worker-post-message')
+      pool = app.createWorkerPool(moduleName, {size: 2})
+      assert.equal(app.listenerCount('worker-post-message'), count + 2)
+      pool.terminate()
+      pool = null
+      const interval = setInterval(function () {
+        if (app.listenerCount('worker-post-message') === count) {
+          clearInterval(interval)
+          done()
+        }
+      }, 50)
+    })
+  })
+
+  describe('app.createWorker(moduleName)', function () {
+    const workerMemory = remote.require(path.join(__dirname, 'fixtures', 'module', 'worker-memory.js'))
+
+    describe('SharedArrayBuffer', function () {
+      it('shares the memory with the worker', function (done) {
+        workerMemory.shareBuffer(function (values) {
+          assert.deepEqual(values, [42, 1, 1, 1])
+          done()
+        })
+      })
+
+      it('keeps the memory once a worker sharing it has stopped', function (done) {
+        workerMemory.shareBufferAfterWorkerStopped(function (value) {
+          assert.equal(value, 2)
+          done()
+        })
+      })
+
+      it('lets workers wait and wake each other with Atomics', function (done) {
+        workerMemory.waitAndWake(function (result) {
+          // The waiter may only start waiting after it has been woken.
+          assert.notEqual(['ok', 'not-equal'].indexOf(result.result), -1)
+          assert.equal(result.value, 1)
+          done()
+        })
+      })
+
+      it('can not be waited on in the main process', function () {
+        assert.notEqual(workerMemory.waitOnMainThread(), null)
+      })
+    })
+
+    describe('transferList', function () {
+      it('hands the ArrayBuffers over without keeping them', function (done) {
+        workerMemory.transferBuffer(function (result) {
+          assert.equal(result.detachedLength, 0)
+          assert.equal(result.receivedLength, 8)
+          assert.deepEqual(result.returned, [42, 43, 0, 0, 0, 0, 0, 0])
+          done()
+        })
+      })
+
+      it('rejects anything but ArrayBuffers that can be transferred', function (done) {
+        workerMemory.transferInvalid(function (errors, byteLength) {
+          assert.ok(/can only contain ArrayBuffers/.test(errors[0]))
+          assert.ok(/can only contain ArrayBuffers/.test(errors[1]))
+          assert.ok(/can't be transferred/.test(errors[2]))
+          // Nothing is detached when the message can't be sent.
+          assert.equal(byteLength, 8)
+          done()
+        })
+      })
+    })
+  })
+
   describe('isAccessibilitySupportEnabled API', function () {
     it('returns whether the Chrome has accessibility APIs enabled', function () {
       assert.equal(typeof app.isAccessibilitySupportEnabled(), 'boolean')
     })
   })
+
+  describe('app.startNetLogging(path[, options][, callback])', function () {
+    const logPath = path.join(remote.app.getPath('temp'), 'electron-spec-net-log.json')
+
+    afterEach(function (done) {
+      app.stopNetLogging(function () {
+        fs.unlink(logPath, function () { done() })
+      })
+    })
+
+    it('calls the callback when there are no options', function (done) {
+      assert.equal(app.startNetLogging(logPath, function (success) {
+        assert.equal(success, true)
+        assert.equal(app.isNetLogging(), true)
+        done()
+      }), true)
+    })
+
+    it('calls the callback after the options', function (done) {
+      app.startNetLogging(logPath, {captureMode: 'includeSensitive'}, function (success) {
+        assert.equal(success, true)
+        done()
+      })
+    })
+  })
 })
@@ -179,6 +179,23 @@ describe('ipc module', function () {
       assert.equal(delete remoteFunctions.aFunction, true)
     })
 
+    it('is counted by the main process', function () {
+      remote.require(path.join(fixtures, 'module', 'property.js'))
+      assert(remote.getCurrentWebContents().getRemoteObjectCount() > 0)
+    })
+
+    it('is kept when fetched again right after its proxy was collected', function (done) {
+      const modulePath = path.join(fixtures, 'module', 'property.js')
+      remote.require(modulePath)
+      global.gc()
+      const property = remote.require(modulePath)
+      // Let the release of the collected proxy reach the main process.
+      setTimeout(function () {
+        assert.equal(property.getFunctionProperty(), 'foo-browser')
+        done()
+      }, 500)
+    })
+
     it('is referenced by its members', function () {
       let stringify = remote.getGlobal('JSON').stringify
       global.gc()
@@ -302,6 +319,14 @@ describe('ipc module', function () {
       base.value = 'old'
     })
 
+    it('changes properties before the next ipc message', function () {
+      const classPath = path.join(fixtures, 'module', 'class.js')
+      base.value = 'new'
+      const script = `require(${JSON.stringify(classPath)}).base.value`
+      assert.equal(ipcRenderer.sendSync('eval', script), 'new')
+      base.value = 'old'
+    })
+
     it('has unenumerable methods', function () {
       assert(!base.hasOwnProperty('method'))
       assert(Object.getPrototypeOf(base).hasOwnProperty('method'))
@@ -316,6 +341,25 @@ describe('ipc module', function () {
       assert(Object.getPrototypeOf(proto).hasOwnProperty('method'))
     })
 
+    it('sends constant properties along', function () {
+      let descriptor = Object.getOwnPropertyDescriptor(cl, 'constant')
+      assert.equal(descriptor.value, 'constant')
+      assert.equal(descriptor.get, undefined)
+    })
+
+    it('does not send constants that JSON can not carry', function () {
+      for (const name of ['infinity', 'notANumber', 'nothing']) {
+        let descriptor = Object.getOwnPropertyDescriptor(cl, name)
+        assert.equal(typeof descriptor.get, 'function')
+      }
+    })
+
+    it('picks up members added to a prototype', function () {
+      assert.equal(cl.createBase().method(), 'method')
+      cl.addMethod()
+      assert.equal(cl.createBase().added(), 'added')
+    })
+
     it('is referenced by methods in prototype chain', function () {
       let method = derived.method
       derived = null
@@ -423,6 +467,82 @@ describe('ipc module', function () {
     })
   })
 
+  describe('ipcRenderer.sendStructured', function () {
+    it('keeps Dates, Maps and binary data', function (done) {
+      const date = new Date()
+      const map = new Map([['a', 1], ['b', {c: [2]}]])
+      const bytes = new Uint8Array([1, 2, 3, 255])
+      ipcRenderer.once('message-structured', function (event, d, m, b, ab) {
+        assert.ok(d instanceof Date)
+        assert.equal(d.getTime(), date.getTime())
+        assert.ok(m instanceof Map)
+        assert.deepEqual(Array.from(m), Array.from(map))
+        assert.ok(b instanceof Uint8Array)
+        assert.deepEqual(Array.from(b), Array.from(bytes))
+        assert.ok(ab instanceof ArrayBuffer)
+        assert.equal(ab.byteLength, 16)
+        done()
+      })
+      ipcRenderer.sendStructured('message-structured', date, map, bytes,
+                                 new ArrayBuffer(16))
+    })
+
+    it('passes large payloads in shared memory', function (done) {
+      const bytes = new Uint8Array(1024 * 1024)
+      for (let i = 0; i < bytes.length; i++) bytes[i] = i % 251
+      ipcRenderer.once('message-structured', function (event, b) {
+        assert.ok(b instanceof Uint8Array)
+        assert.equal(b.length, bytes.length)
+        assert.equal(b[bytes.length - 1], (bytes.length - 1) % 251)
+        done()
+      })
+      ipcRenderer.sendStructured('message-structured', bytes)
+    })
+
+    it('throws for values that can not be cloned', function () {
+      assert.throws(function () {
+        ipcRenderer.sendStructured('message-structured', function () {})
+      })
+    })
+
+    // Only logs timings and takes a while, so it is skipped unless
+    // ELECTRON_SPEC_BENCHMARKS is set.
+    const benchmark = process.env.ELECTRON_SPEC_BENCHMARKS ? it : xit
+
+    benchmark('benchmarks large payloads against JSON', function (done) {
+      this.timeout(60000)
+
+      const rounds = 20
+      const payload = []
+      for (let i = 0; i < 10000; i++) {
+        payload.push({id: i, name: `item ${i}`, tags: ['a', 'b'], at: i * 1.5})
+      }
+
+      const time = function (method, channel, callback) {
+        let remaining = rounds
+        const start = window.performance.now()
+        const onMessage = function () {
+          if (--remaining > 0) {
+            ipcRenderer[method](channel, payload)
+            return
+          }
+          ipcRenderer.removeListener(channel, onMessage)
+          callback(window.performance.now() - start)
+        }
+        ipcRenderer.on(channel, onMessage)
+        ipcRenderer[method](channel, payload)
+      }
+
+      time('send', 'message', function (json) {
+        time('sendStructured', 'message-structured', function (structured) {
+          console.log(`${rounds} round trips: JSON ${json.toFixed(1)}ms, ` +
+                      `structured clone ${structured.toFixed(1)}ms`)
+          done()
+        })
+      })
+    })
+  })
+
   describe('ipc.sendSync', function () {
     afterEach(function () {
       ipcMain.removeAllListeners('send-sync-message')
@@ -433,6 +553,34 @@ describe('ipc module', function () {
       assert.equal(msg, 'test')
     })
 
+    it('keeps Dates and binary data in event.returnValue', function () {
+      const result = ipcRenderer.sendSync('sync-structured-result', true)
+      assert.ok(result.date instanceof Date)
+      assert.equal(result.date.getTime(), 0)
+      assert.ok(result.bytes instanceof Uint8Array)
+      assert.deepEqual(Array.from(result.bytes), [1, 2, 3])
+    })
+
+    it('falls back to JSON for values that can not be cloned', function () {
+      const result = ipcRenderer.sendSync('sync-structured-result', false)
+      assert.equal(typeof result.date, 'string')
+      assert.equal(result.fn, undefined)
+    })
+
+    it('is counted in app.getIPCStats()', function () {
+      remote.app.resetIPCStats()
+      remote.app.startIPCStats()
+      ipcRenderer.sendSync('echo', 'test')
+      remote.app.stopIPCStats()
+      const stats = remote.app.getIPCStats().find(function (entry) {
+        return entry.channel === 'echo' &&
+          entry.direction === 'renderer-to-browser-sync'
+      })
+      assert.equal(stats.count, 1)
+      assert.ok(stats.bytes > 0)
+      assert.equal(typeof stats.maxBlockedTime, 'number')
+    })
+
     it('does not crash when reply is not sent and browser is destroyed', function (done) {
       this.timeout(10000)
 
@@ -1,7 +1,9 @@
 const assert = require('assert')
+const ChildProcess = require('child_process')
 const http = require('http')
 const path = require('path')
 const fs = require('fs')
+const temp = require('temp')
 const {closeWindow} = require('./window-helpers')
 
 const {ipcRenderer, remote} = require('electron')
@@ -179,6 +181,365 @@ describe('session module', function () {
         })
       })
     })
+
+    it('delivers the changes of the cookies matching a subscription', function (done) {
+      const {cookies} = session.fromPartition('cookie-changes')
+      const changes = []
+      const id = cookies.subscribe({url: url, interval: 10}, function (batch) {
+        for (const change of batch) {
+          changes.push([change.cause, change.cookie.value])
+        }
+        if (changes.length === 1) {
+          assert.deepEqual(changes, [['added', '1']])
+          cookies.set({url: url, name: 'changed', value: '2'}, function (error) {
+            if (error) done(error)
+          })
+        } else if (changes.length === 3) {
+          cookies.unsubscribe(id)
+          assert.deepEqual(changes, [['added', '1'], ['overwritten', '1'], ['added', '2']])
+          done()
+        }
+      })
+      // Not matching the url of the subscription.
+      cookies.set({url: 'http://example.com', name: 'changed', value: '0'}, function (error) {
+        if (error) return done(error)
+        cookies.set({url: url, name: 'changed', value: '1'}, function (error) {
+          if (error) done(error)
+        })
+      })
+    })
+
+    it('sets and removes many cookies at once', function (done) {
+      const {cookies} = session.fromPartition('cookie-batches')
+      cookies.setMany([
+        {url: url, name: 'a', value: '1'},
+        {url: url, name: 'b', value: '2'}
+      ], function (error, results) {
+        if (error) return done(error)
+        assert.deepEqual(results, [true, true])
+        cookies.get({url: url}, function (error, list) {
+          if (error) return done(error)
+          assert.deepEqual(list.map((c) => c.name + '=' + c.value).sort(), ['a=1', 'b=2'])
+          cookies.removeMany([
+            {url: url, name: 'a'},
+            {url: url, name: 'b'},
+            {url: url, name: 'missing'}
+          ], function (error, results) {
+            if (error) return done(error)
+            assert.deepEqual(results, [1, 1, 0])
+            cookies.get({url: url}, function (error, list) {
+              if (error) return done(error)
+              assert.equal(list.length, 0)
+              done()
+            })
+          })
+        })
+      })
+    })
+
+    it('calls back with an error when removing cookies without a name', function (done) {
+      const {cookies} = session.fromPartition('cookie-batches')
+      cookies.set({url: url, name: 'kept', value: '1'}, function (error) {
+        if (error) return done(error)
+        cookies.removeMany([{url: url}, {url: url, name: 'kept'}], function (error, results) {
+          assert(error)
+          assert(/Removing cookies failed/.test(error.message))
+          assert.deepEqual(results, [0, 1])
+          done()
+        })
+      })
+    })
+
+    it('imports the exported cookies', function (done) {
+      const {cookies} = session.fromPartition('cookie-export')
+      cookies.setMany([
+        {url: url, name: 'a', value: '1', httpOnly: true},
+        {url: url, name: 'b', value: '2', expirationDate: Math.floor(Date.now() / 1000) + 3600}
+      ], function (error) {
+        if (error) return done(error)
+        cookies.export({url: url}, function (error, exported) {
+          if (error) return done(error)
+          assert.equal(exported.length, 2)
+          cookies.removeMany([{url: url, name: 'a'}, {url: url, name: 'b'}], function (error) {
+            if (error) return done(error)
+            cookies.import(exported, function (error, results) {
+              if (error) return done(error)
+              assert.deepEqual(results, [true, true])
+              cookies.export({url: url}, function (error, imported) {
+                if (error) return done(error)
+                const summarize = (c) => [c.name, c.value, c.httpOnly, c.expirationDate].join()
+                assert.deepEqual(imported.map(summarize).sort(), exported.map(summarize).sort())
+                done()
+              })
+            })
+          })
+        })
+      })
+    })
+
+    it('replaces the existing cookies on import when asked to', function (done) {
+      const {cookies} = session.fromPartition('cookie-import')
+      cookies.set({url: url, name: 'old', value: '1'}, function (error) {
+        if (error) return done(error)
+        cookies.import([{url: url, name: 'new', value: '2'}], {replace: true}, function (error, results) {
+          if (error) return done(error)
+          assert.deepEqual(results, [true])
+          cookies.get({}, function (error, list) {
+            if (error) return done(error)
+            assert.deepEqual(list.map((c) => c.name + '=' + c.value), ['new=2'])
+            done()
+          })
+        })
+      })
+    })
+
+    it('rejects queries for pages of no cookies', function () {
+      assert.throws(function () {
+        session.defaultSession.cookies.query({limit: 0}, function () {})
+      }, /`limit` must be greater than 0/)
+    })
+
+    describe('cookies.query', function () {
+      const {cookies} = session.fromPartition('cookie-query')
+      const expirationDate = Math.floor(Date.now() / 1000) + 3600
+
+      before(function (done) {
+        cookies.setMany([
+          {url: url, name: 'a', value: '1'},
+          {url: url, name: 'b', value: '2'},
+          {url: url, name: 'c', value: '3'},
+          {url: url, name: 'd', value: '4'},
+          {url: url, name: 'e', value: '5', expirationDate: expirationDate},
+          {url: 'http://example.com', name: 'f', value: '6', expirationDate: expirationDate},
+          {url: 'http://example.com', name: 'g', value: '7'}
+        ], done)
+      })
+
+      const query = function (options) {
+        return new Promise(function (resolve, reject) {
+          cookies.query(options, function (error, page) {
+            if (error) reject(error)
+            else resolve(page)
+          })
+        })
+      }
+
+      it('continues from the offset of the previous page', function () {
+        const names = []
+        const collect = function (page) {
+          for (const cookie of page.cookies) names.push(cookie.name)
+        }
+        return query({url: url, limit: 2}).then(function (page) {
+          assert.equal(page.cookies.length, 2)
+          assert.equal(page.nextOffset, 2)
+          collect(page)
+          return query({url: url, offset: page.nextOffset, limit: 2})
+        }).then(function (page) {
+          assert.equal(page.cookies.length, 2)
+          assert.equal(page.nextOffset, 4)
+          collect(page)
+          return query({url: url, offset: page.nextOffset, limit: 2})
+        }).then(function (page) {
+          assert.equal(page.cookies.length, 1)
+          assert.equal(page.nextOffset, undefined)
+          collect(page)
+          assert.deepEqual(names.sort(), ['a', 'b', 'c', 'd', 'e'])
+        })
+      })
+
+      it('does not give a next offset for a full last page', function () {
+        return query({url: url, limit: 5}).then(function (page) {
+          assert.equal(page.cookies.length, 5)
+          assert.equal(page.nextOffset, undefined)
+          return query({url: url, offset: 5})
+        }).then(function (page) {
+          assert.deepEqual(page.cookies, [])
+          assert.equal(page.nextOffset, undefined)
+        })
+      })
+
+      it('applies every filter to each cookie of the page', function () {
+        return query({domain: 'example.com', session: false}).then(function (page) {
+          assert.deepEqual(page.cookies.map((c) => c.name), ['f'])
+          return query({url: url, name: 'c'})
+        }).then(function (page) {
+          assert.deepEqual(page.cookies.map((c) => c.value), ['3'])
+          return query({session: true, limit: 1, offset: 4})
+        }).then(function (page) {
+          // a, b, c, d and g are the session cookies.
+          assert.equal(page.cookies.length, 1)
+          assert.equal(page.cookies[0].session, true)
+          assert.equal(page.nextOffset, undefined)
+        })
+      })
+
+      it('returns only the requested fields', function () {
+        return query({url: url, name: 'e', fields: ['name', 'expirationDate']}).then(function (page) {
+          assert.deepEqual(page.cookies, [{name: 'e', expirationDate: expirationDate}])
+        })
+      })
+    })
+  })
+
+  describe('ses.userPrefs', function () {
+    const {userPrefs} = session.fromPartition('persist:user-prefs')
+
+    before(function () {
+      userPrefs.registerDictionaryPref('spec.sites', {}, false)
+    })
+
+    afterEach(function () {
+      userPrefs.observePref('spec.sites', null)
+      userPrefs.observePref('app_state', null)
+      userPrefs.setPref('spec.sites', [], {})
+      userPrefs.removeAppState('siteSettings')
+    })
+
+    it('reads and writes nested entries of dictionary prefs', function () {
+      userPrefs.setPref('spec.sites', ['example.com', 'zoom'], 2)
+      assert.deepEqual(userPrefs.getPref('spec.sites'), {'example.com': {zoom: 2}})
+      assert.deepEqual(userPrefs.getPref('spec.sites', 'example.com'), {zoom: 2})
+      assert.equal(userPrefs.getPref('spec.sites', ['example.com', 'zoom']), 2)
+      assert.equal(userPrefs.getPref('spec.sites', ['missing', 'zoom']), null)
+
+      userPrefs.removePref('spec.sites', ['example.com', 'zoom'])
+      assert.deepEqual(userPrefs.getPref('spec.sites'), {'example.com': {}})
+    })
+
+    it('reads and writes nested entries of the app state', function () {
+      userPrefs.setPref('app_state', ['siteSettings', 'example.com'], {zoom: 2})
+      assert.deepEqual(userPrefs.getAppState('siteSettings'), {'example.com': {zoom: 2}})
+      assert.equal(userPrefs.getPref('app_state', ['siteSettings', 'example.com', 'zoom']), 2)
+
+      userPrefs.removePref('app_state', ['siteSettings', 'example.com'])
+      assert.deepEqual(userPrefs.getAppState(['siteSettings']), {})
+    })
+
+    it('calls pref observers with the changed paths', function (done) {
+      const changes = []
+      userPrefs.observePref('spec.sites', function (name, paths) {
+        changes.push([name, paths])
+        if (changes.length < 3) return
+        assert.deepEqual(changes, [
+          ['spec.sites', [['example.com', 'zoom']]],
+          ['spec.sites', [['example.com']]],
+          ['spec.sites', [[]]]
+        ])
+        done()
+      })
+      userPrefs.setPref('spec.sites', ['example.com', 'zoom'], 2)
+      userPrefs.removePref('spec.sites', 'example.com')
+      userPrefs.setDictionaryPref('spec.sites', {other: true})
+    })
+
+    it('calls app state observers with the changed paths', function (done) {
+      const changes = []
+      userPrefs.observePref('app_state', function (name, paths) {
+        changes.push([name, paths])
+        if (changes.length < 2) return
+        assert.deepEqual(changes, [
+          ['app_state', [['siteSettings', 'example.com']]],
+          ['app_state', [['siteSettings', 'example.com']]]
+        ])
+        done()
+      })
+      userPrefs.setAppState(['siteSettings', 'example.com'], {zoom: 1})
+      userPrefs.removeAppState(['siteSettings', 'example.com'])
+    })
+  })
+
+  describe('ses.userPrefs app state', function () {
+    this.timeout(60000)
+
+    temp.track()
+
+    // Runs |operations| on the app state of the profile in |userData| in a
+    // new app, and resolves with the values read.
+    const runApp = function (userData, operations) {
+      return new Promise(function (resolve, reject) {
+        const appPath = path.join(fixtures, 'api', 'app-state')
+        const appProcess = ChildProcess.spawn(remote.process.execPath,
+          [appPath, userData, JSON.stringify(operations)])
+        appProcess.on('close', function (code) {
+          if (code !== 0) {
+            return reject(new Error(`App exited with code ${code}`))
+          }
+          resolve(JSON.parse(fs.readFileSync(path.join(userData, 'results.json'))))
+        })
+      })
+    }
+
+    it('keeps the changes across restarts', function () {
+      const userData = temp.mkdirSync('app-state')
+      return runApp(userData, [
+        ['set', ['siteSettings', 'https://example.com'], {zoom: 1}],
+        ['set', 'tabs', [1, 2]],
+        ['set', ['window', 'width'], 800],
+        ['remove', 'tabs']
+      ]).then(function () {
+        assert(fs.existsSync(path.join(userData, 'App State Journal')))
+        return runApp(userData, [
+          ['get', ['siteSettings', 'https://example.com', 'zoom']],
+          ['get', []]
+        ])
+      }).then(function (results) {
+        assert.deepEqual(results, [1, {
+          siteSettings: {'https://example.com': {zoom: 1}},
+          window: {width: 800}
+        }])
+      })
+    })
+
+    it('folds a large journal into the snapshot', function () {
+      const userData = temp.mkdirSync('app-state')
+      const size = 2 * 1024 * 1024
+      return runApp(userData, [['setLarge', 'large', size]]).then(function () {
+        assert(!fs.existsSync(path.join(userData, 'App State Journal')))
+        const snapshot = fs.readFileSync(path.join(userData, 'App State'))
+        assert.equal(JSON.parse(snapshot).large.length, size)
+        return runApp(userData, [['get', 'large']])
+      }).then(function (results) {
+        assert.equal(results[0].length, size)
+      })
+    })
+
+    it('replays the journal up to a torn record', function () {
+      const userData = temp.mkdirSync('app-state')
+      fs.writeFileSync(path.join(userData, 'App State'),
+        JSON.stringify({a: 1, b: {c: 2}}))
+      fs.writeFileSync(path.join(userData, 'App State Journal'), [
+        JSON.stringify({path: ['b', 'c.d'], value: 3}),
+        JSON.stringify({path: ['a']}),
+        '{"path": ["e"], "val'
+      ].join('\n'))
+      return runApp(userData, [['get', []]]).then(function (results) {
+        assert.deepEqual(results, [{b: {c: 2, 'c.d': 3}}])
+        // The state is written again without the torn record.
+        assert(!fs.existsSync(path.join(userData, 'App State Journal')))
+        const snapshot = fs.readFileSync(path.join(userData, 'App State'))
+        assert.deepEqual(JSON.parse(snapshot), {b: {c: 2, 'c.d': 3}})
+      })
+    })
+
+    it('migrates the app_state pref once', function () {
+      const userData = temp.mkdirSync('app-state')
+      const appState = {siteSettings: {'example.com': {zoom: 1}}}
+      fs.writeFileSync(path.join(userData, 'UserPrefs'),
+        JSON.stringify({app_state: appState}))
+      return runApp(userData, [['get', []]]).then(function (results) {
+        assert.deepEqual(results, [appState])
+        const prefs = JSON.parse(fs.readFileSync(path.join(userData, 'UserPrefs')))
+        assert.equal(prefs.app_state, undefined)
+        assert.equal(prefs.app_state_migrated, true)
+
+        // A stale app_state pref is not migrated again.
+        prefs.app_state = {stale: true}
+        fs.writeFileSync(path.join(userData, 'UserPrefs'), JSON.stringify(prefs))
+        return runApp(userData, [['get', []]])
+      }).then(function (results) {
+        assert.deepEqual(results, [appState])
+      })
+    })
   })
 
   describe('ses.clearStorageData(options)', function () {
@@ -97,4 +97,64 @@ describe('webContents module', function () {
       })
     })
   })
+
+  describe('event listeners', function () {
+    it('emits events to listeners added after creation', function (done) {
+      w.webContents.once('did-finish-load', function () {
+        done()
+      })
+      w.loadURL('about:blank')
+    })
+
+    it('emits events to listeners added after removeAllListeners()', function (done) {
+      w.webContents.removeAllListeners()
+      w.webContents.once('did-finish-load', function () {
+        done()
+      })
+      w.loadURL('about:blank')
+    })
+  })
+
+  describe('setEventCoalescing() API', function () {
+    it('emits the events of an interval in a batch', function (done) {
+      w.webContents.setEventCoalescing('did-finish-load', {
+        interval: 1000,
+        mode: 'batch'
+      })
+      w.webContents.once('did-finish-load', function (event, batch) {
+        assert.ok(Array.isArray(batch))
+        assert.equal(batch.length, 1)
+        assert.deepEqual(batch[0], [])
+        done()
+      })
+      w.loadURL('about:blank')
+    })
+
+    it('emits held back events before the other events', function (done) {
+      let started = 0
+      w.webContents.setEventCoalescing('did-start-loading', {interval: 10000})
+      w.webContents.on('did-start-loading', function () {
+        started++
+      })
+      w.webContents.once('did-finish-load', function () {
+        assert.equal(started, 1)
+        // The next did-start-loading is held back until did-finish-load.
+        w.webContents.once('did-finish-load', function () {
+          assert.equal(started, 2)
+          done()
+        })
+        w.loadURL('about:blank')
+      })
+      w.loadURL('about:blank')
+    })
+
+    it('throws for an invalid mode', function () {
+      assert.throws(function () {
+        w.webContents.setEventCoalescing('did-finish-load', {
+          interval: 1000,
+          mode: 'first'
+        })
+      }, /Invalid `mode`/)
+    })
+  })
 })
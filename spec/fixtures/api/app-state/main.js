@@ -0,0 +1,36 @@
+// Runs the operations passed on the command line on the app state of a
+// profile, and writes what they read to results.json in the profile.
+const {app, session} = require('electron')
+const fs = require('fs')
+const path = require('path')
+
+const [userData, operations] = process.argv.slice(2)
+
+process.on('uncaughtException', () => {
+  app.exit(1)
+})
+
+app.setPath('userData', userData)
+
+app.once('ready', () => {
+  const {userPrefs} = session.defaultSession
+  const results = []
+  for (const [operation, key, value] of JSON.parse(operations)) {
+    switch (operation) {
+      case 'get':
+        results.push(userPrefs.getAppState(key))
+        break
+      case 'set':
+        userPrefs.setAppState(key, value)
+        break
+      case 'setLarge':
+        userPrefs.setAppState(key, 'x'.repeat(value))
+        break
+      case 'remove':
+        userPrefs.removeAppState(key)
+        break
+    }
+  }
+  fs.writeFileSync(path.join(userData, 'results.json'), JSON.stringify(results))
+  app.quit()
+})
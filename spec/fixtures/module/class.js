@@ -25,5 +25,18 @@ class DerivedClass extends BaseClass {
 
 module.exports = {
   base: new BaseClass(),
-  derived: new DerivedClass()
+  derived: new DerivedClass(),
+  createBase () {
+    return new BaseClass()
+  },
+  addMethod () {
+    BaseClass.prototype.added = function () {
+      return 'added'
+    }
+  }
 }
+
+Object.defineProperty(module.exports, 'constant', {value: 'constant'})
+Object.defineProperty(module.exports, 'infinity', {value: Infinity})
+Object.defineProperty(module.exports, 'notANumber', {value: NaN})
+Object.defineProperty(module.exports, 'nothing', {value: undefined})
@@ -0,0 +1,103 @@
+// Runs the worker memory specs in the main process, which owns the workers,
+// and calls back with plain values.
+const {app} = require('electron')
+
+const moduleName = 'spec/fixtures/workers/memory_worker'
+
+const startWorker = function (callback) {
+  const worker = app.createWorker(moduleName)
+  worker.start(() => callback(worker))
+}
+
+const request = function (worker, message, transferList, callback) {
+  worker.once('message', (event) => callback(event.data))
+  worker.postMessage(message, transferList)
+}
+
+exports.shareBuffer = function (callback) {
+  const array = new Int32Array(new SharedArrayBuffer(16))
+  array[0] = 41
+  startWorker((worker) => {
+    request(worker, {type: 'increment', buffer: array.buffer}, undefined, () => {
+      worker.terminate()
+      callback(Array.from(array))
+    })
+  })
+}
+
+exports.shareBufferAfterWorkerStopped = function (callback) {
+  const array = new Int32Array(new SharedArrayBuffer(4))
+  startWorker((first) => {
+    request(first, {type: 'increment', buffer: array.buffer}, undefined, () => {
+      first.once('stop', () => {
+        // The stopped worker has released the memory, which is still ours.
+        startWorker((second) => {
+          request(second, {type: 'increment', buffer: array.buffer}, undefined, () => {
+            second.terminate()
+            callback(array[0])
+          })
+        })
+      })
+      first.terminate()
+    })
+  })
+}
+
+exports.waitAndWake = function (callback) {
+  const buffer = new SharedArrayBuffer(4)
+  startWorker((waiter) => {
+    startWorker((waker) => {
+      request(waiter, {type: 'wait', buffer}, undefined, (result) => {
+        waiter.terminate()
+        waker.terminate()
+        callback(result)
+      })
+      request(waker, {type: 'wake', buffer}, undefined, () => {})
+    })
+  })
+}
+
+exports.waitOnMainThread = function () {
+  try {
+    Atomics.wait(new Int32Array(new SharedArrayBuffer(4)), 0, 0, 0)
+    return null
+  } catch (error) {
+    return error.message
+  }
+}
+
+exports.transferBuffer = function (callback) {
+  const buffer = new ArrayBuffer(8)
+  new Uint8Array(buffer)[0] = 42
+  startWorker((worker) => {
+    request(worker, {type: 'transfer', buffer}, [buffer], (result) => {
+      worker.terminate()
+      callback({
+        detachedLength: buffer.byteLength,
+        receivedLength: result.byteLength,
+        returned: Array.from(new Uint8Array(result.buffer))
+      })
+    })
+  })
+}
+
+exports.transferInvalid = function (callback) {
+  startWorker((worker) => {
+    const buffer = new ArrayBuffer(8)
+    const transferLists = [
+      [{}],
+      [new SharedArrayBuffer(8)],
+      [buffer, buffer]
+    ]
+    const errors = transferLists.map((transferList) => {
+      try {
+        worker.postMessage({buffer}, transferList)
+        return null
+      } catch (error) {
+        return error.message
+      }
+    })
+    worker.terminate()
+    callback(errors, buffer.byteLength)
+  })
+}
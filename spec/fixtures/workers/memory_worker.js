@@ -0,0 +1,31 @@
+self.onmessage = function (event) {
+  var data = event.data
+  var array
+  switch (data.type) {
+    case 'increment':
+      array = new Int32Array(data.buffer)
+      for (var i = 0; i < array.length; i++) {
+        Atomics.add(array, i, 1)
+      }
+      postMessage({})
+      break
+    case 'wait':
+      array = new Int32Array(data.buffer)
+      var result = Atomics.wait(array, 0, 0, 5000)
+      postMessage({result: result, value: Atomics.load(array, 0)})
+      break
+    case 'wake':
+      array = new Int32Array(data.buffer)
+      Atomics.store(array, 0, 1)
+      Atomics.wake(array, 0, 1)
+      postMessage({})
+      break
+    case 'transfer':
+      // Sends the buffer back, changed, and without copying it.
+      array = new Uint8Array(data.buffer)
+      array[1] = array[0] + 1
+      postMessage({byteLength: data.buffer.byteLength, buffer: data.buffer},
+                  [data.buffer])
+      break
+  }
+}
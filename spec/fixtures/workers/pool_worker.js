@@ -0,0 +1,6 @@
+self.onmessage = function (event) {
+  // Keeps the worker busy for the given time before replying.
+  var end = Date.now() + (event.data.wait || 0)
+  while (Date.now() < end) {}
+  postMessage(event.data.value)
+}
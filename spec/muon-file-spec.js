@@ -0,0 +1,70 @@
+const assert = require('assert')
+const fs = require('fs')
+const path = require('path')
+const temp = require('temp').track()
+const zlib = require('zlib')
+
+const {remote} = require('electron')
+
+describe('muon.file module', function () {
+  this.timeout(10000)
+
+  const file = remote.getGlobal('muon').file
+  let dir = null
+
+  beforeEach(function () {
+    dir = temp.mkdirSync('muon-file-spec-')
+  })
+
+  describe('file.writeImportant(path, data[, options], callback)', function () {
+    it('writes the data right away by default', function (done) {
+      const target = path.join(dir, 'now.json')
+      file.writeImportant(target, 'now', function (success) {
+        assert.equal(success, true)
+        assert.equal(fs.readFileSync(target, 'utf8'), 'now')
+        done()
+      })
+    })
+
+    it('coalesces the writes made within the delay', function (done) {
+      const target = path.join(dir, 'coalesced.json')
+      const results = []
+      const onWritten = function (success) {
+        results.push(success)
+        // Every callback sees the latest data, as there is a single write.
+        assert.equal(fs.readFileSync(target, 'utf8'), '3')
+        if (results.length === 3) {
+          assert.deepEqual(results, [true, true, true])
+          done()
+        }
+      }
+      file.writeImportant(target, '1', {delay: 500}, onWritten)
+      file.writeImportant(target, '2', {delay: 500}, onWritten)
+      file.writeImportant(target, '3', {delay: 500}, onWritten)
+      assert.equal(fs.existsSync(target), false)
+    })
+
+    it('compresses the data when asked to', function (done) {
+      const target = path.join(dir, 'compressed.json.gz')
+      file.writeImportant(target, 'compressed', {compress: true}, function (success) {
+        assert.equal(success, true)
+        assert.equal(zlib.gunzipSync(fs.readFileSync(target)).toString(), 'compressed')
+        done()
+      })
+    })
+  })
+
+  describe('file.flush()', function () {
+    it('writes the pending data at once', function (done) {
+      const target = path.join(dir, 'flushed.json')
+      file.writeImportant(target, 'old', {delay: 60000}, function (success) {
+        assert.equal(success, true)
+        assert.equal(fs.readFileSync(target, 'utf8'), 'new')
+        done()
+      })
+      file.writeImportant(target, 'new', {delay: 60000})
+      assert.equal(fs.existsSync(target), false)
+      file.flush()
+    })
+  })
+})
@@ -40,6 +40,18 @@ ipcMain.on('message', function (event, ...args) {
   event.sender.send('message', ...args)
 })
 
+ipcMain.on('message-structured', function (event, ...args) {
+  event.sender.sendStructured('message-structured', ...args)
+})
+
+ipcMain.on('sync-structured-result', function (event, cloneable) {
+  event.returnValue = {
+    date: new Date(0),
+    bytes: new Uint8Array([1, 2, 3]),
+    fn: cloneable ? undefined : function () {}
+  }
+})
+
 // Set productName so getUploadedReports() uses the right directory in specs
 if (process.platform === 'win32') {
   crashReporter.productName = 'Zombies'